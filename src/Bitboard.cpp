@@ -1,100 +1,99 @@
 #include "Bitboard.h"
 #include <bit>
 
-std::array<U64, 8> BB::excludeFiles = { 0xFFFFFFFFFFFFFFFF, 0x7f7f7f7f7f7f7f7f, 0x3F3F3F3F3F3F3F3F, 0, 0, 0, 0xFCFCFCFCFCFCFCFC, 0xFEFEFEFEFEFEFEFE };
-
-// returns bit position of first 1 in a bitboard, when there are no ones, returns -1 
-int BB::bitScanForward(U64 x)
+// step from a square by a file and rank offset, returns -1 if the step leaves the board
+static constexpr int stepSquare(int square, int fileStep, int rankStep)
 {
-	if (x == 0)
-	{
-		return -1;
-	}
-
-	return std::countr_zero(x);
+	int file = square % 8 + fileStep;
+	int rank = square / 8 + rankStep;
+	return (file >= 0 && file < 8 && rank >= 0 && rank < 8) ? rank * 8 + file : -1;
 }
 
-// number of ones in bitboard
-int BB::popCount(U64 x)
+// attacks of a piece which jumps by the given steps, for every square
+static constexpr std::array<U64, 64> generateLeaperAttacks(std::array<std::array<int, 2>, 8> steps)
 {
-	return std::popcount(x);
-}
+	std::array<U64, 64> attacks = {};
+	for (int square = 0; square < 64; square++)
+	{
+		for (std::array<int, 2> step : steps)
+		{
+			int target = stepSquare(square, step[0], step[1]);
+			if (target != -1)
+			{
+				attacks[square] |= U64(1) << target;
+			}
+		}
+	}
 
-// shift bitboard by signed int
-U64 BB::genShift(U64 x, int shift)
-{
-	return (shift > 0) ? (x << shift) : (x >> -shift);
+	return attacks;
 }
 
-// shift bitboard by max two tiles (knight moves) in any direction
-U64 BB::shiftTwo(U64 x, int shift)
+// squares in between (or the whole line through) every pair of squares on a common rank, file or diagonal
+static constexpr std::array<std::array<U64, 64>, 64> generateLines(bool wholeLine)
 {
-	int horizontal = (shift % 8 + 8) % 8;
+	constexpr std::array<std::array<int, 2>, 8> steps = { { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { -1, -1 }, { 1, -1 }, { -1, 1 } } };
 
-	// erase file according to offset
-	x &= excludeFiles[horizontal];
+	std::array<std::array<U64, 64>, 64> lines = {};
+	for (int from = 0; from < 64; from++)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			// the full line consists of the ray in this direction, the ray in the opposite direction and the square itself
+			U64 fullLine = U64(1) << from;
+			for (int j = i - i % 2; j <= i - i % 2 + 1; j++)
+			{
+				for (int square = stepSquare(from, steps[j][0], steps[j][1]); square != -1; square = stepSquare(square, steps[j][0], steps[j][1]))
+				{
+					fullLine |= U64(1) << square;
+				}
+			}
+
+			// walk along the ray, the squares passed so far are in between
+			U64 passed = U64(0);
+			for (int to = stepSquare(from, steps[i][0], steps[i][1]); to != -1; to = stepSquare(to, steps[i][0], steps[i][1]))
+			{
+				lines[from][to] = wholeLine ? fullLine : passed;
+				passed |= U64(1) << to;
+			}
+		}
+	}
 
-	return genShift(x, shift);
+	return lines;
 }
 
-// calculate king attacks by parallel prefix
-U64 BB::kingAttacks(U64 kingSet)
-{
-	kingSet |= shiftTwo(kingSet, EAST) | shiftTwo(kingSet, WEST);
-	kingSet |= shiftTwo(kingSet, SOUTH) | shiftTwo(kingSet, NORTH);
-	return kingSet;
-}
+constexpr std::array<U64, 64> BB::kingAttackTable = generateLeaperAttacks({ { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { -1, -1 }, { 1, -1 }, { -1, 1 } } });
+constexpr std::array<U64, 64> BB::knightAttackTable = generateLeaperAttacks({ { { 1, 2 }, { 2, 1 }, { 2, -1 }, { 1, -2 }, { -1, -2 }, { -2, -1 }, { -2, 1 }, { -1, 2 } } });
+constexpr std::array<std::array<U64, 64>, 64> BB::betweenTable = generateLines(false);
+constexpr std::array<std::array<U64, 64>, 64> BB::lineTable = generateLines(true);
 
 // calculate knight attacks by parallel prefix
 U64 BB::knightAttacks(U64 knightSet)
 {
 	U64 west, east, attacks;
-	east = shiftTwo(knightSet, EAST);
-	west = shiftTwo(knightSet, WEST);
-	attacks = genShift(east | west, NORTH + NORTH);
-	attacks |= genShift(east | west, SOUTH + SOUTH);
-	east = shiftTwo(east, EAST);
-	west = shiftTwo(west, WEST);
-	attacks |= genShift(east | west, NORTH);
-	attacks |= genShift(east | west, SOUTH);
+	east = shift<EAST>(knightSet);
+	west = shift<WEST>(knightSet);
+	attacks = shift<NORTH + NORTH>(east | west);
+	attacks |= shift<SOUTH + SOUTH>(east | west);
+	east = shift<EAST>(east);
+	west = shift<WEST>(west);
+	attacks |= shift<NORTH>(east | west);
+	attacks |= shift<SOUTH>(east | west);
 	return attacks;
 }
 
-// cast a ray in given direction, stopping at taken squares
-U64 BB::rayAttacks(U64 set, U64 empty, int shift)
-{
-
-	for (int cycle = 0; cycle < 7; cycle++)
-	{
-		set |= empty & shiftTwo(set, shift);
-	}
-
-	return shiftTwo(set, shift);
-}
-
-// return pawn attacks in given direction
-U64 BB::pawnDirAttacks(U64 pawnSet, int color, int shift)
-{
-	return shiftTwo(pawnSet, shift + (color == WHITE ? NORTH : SOUTH));
-}
-
 // return pawn attacks in any direction
 U64 BB::pawnAnyAttacks(U64 pawnSet, int color)
 {
-	return pawnDirAttacks(pawnSet, color, EAST) | pawnDirAttacks(pawnSet, color, WEST);
-}
+	if (color == WHITE)
+	{
+		return shift<NORTH_EAST>(pawnSet) | shift<NORTH_WEST>(pawnSet);
+	}
 
-// fill set in a direction from the taken squares (Kogge-Stone algorithm)
-U64 BB::dirFill(U64 set, int shift, bool excludeOriginal)
-{
-	set |= shiftTwo(set, shift);
-	set |= shiftTwo(set, 2 * shift);
-	set |= shiftTwo(set, 4 * shift);
-	return excludeOriginal ? shiftTwo(set, shift) : set;
+	return shift<SOUTH_EAST>(pawnSet) | shift<SOUTH_WEST>(pawnSet);
 }
 
 // fill files of taken squares
 U64 BB::fileFill(U64 set)
 {
-	return dirFill(set, NORTH, false) | dirFill(set, SOUTH, false);
+	return dirFill<NORTH>(set, false) | dirFill<SOUTH>(set, false);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <array>
 #include <cstdint>
 #include "Piece.h"
+#include "Cpu.h"
 
 // rename integers for easier access to bitboards
 typedef uint64_t U64;
@@ -34,26 +35,69 @@ enum Directions
 // class for altering bitboards
 class BB
 {
-	// bitmasks for excluding certain files when shifting bitboards
-	static std::array<U64, 8> excludeFiles;
+	// attack, between and line tables generated at compile time
+	static const std::array<U64, 64> kingAttackTable;
+	static const std::array<U64, 64> knightAttackTable;
+	static const std::array<std::array<U64, 64>, 64> betweenTable;
+	static const std::array<std::array<U64, 64>, 64> lineTable;
 
 public:
-	// general operations
-	static int bitScanForward(U64 x);
-	static int popCount(U64 x);
+	// general operations, popcount uses the popcnt instruction if the CPU has it (bit scans compile to bsf/tzcnt on every CPU)
+	static int bitScanForward(U64 x) { return (x == 0) ? -1 : std::countr_zero(x); }
+	static int popCount(U64 x) { return Cpu::popcnt ? Cpu::popcntInstruction(x) : std::popcount(x); }
 
-	// shifting bitboards
-	static U64 genShift(U64 x, int shift);
-	static U64 shiftTwo(U64 x, int shift);
+	// mirror a bitboard vertically (rank 1 becomes rank 8)
+	static U64 flipVertical(U64 x)
+	{
+#if defined(_MSC_VER)
+		return _byteswap_uint64(x);
+#else
+		return __builtin_bswap64(x);
+#endif
+	}
 
-	// attacks for pieces
-	static U64 kingAttacks(U64 kingSet);
+	// shift bitboard by max two tiles in a direction known at compile time
+	template <int Shift>
+	static constexpr U64 shift(U64 x)
+	{
+		constexpr int horizontal = (Shift % 8 + 8) % 8;
+		constexpr U64 mask = (horizontal == 1) ? U64(0x7F7F7F7F7F7F7F7F) : (horizontal == 2) ? U64(0x3F3F3F3F3F3F3F3F)
+			: (horizontal == 6) ? U64(0xFCFCFCFCFCFCFCFC) : (horizontal == 7) ? U64(0xFEFEFEFEFEFEFEFE) : ~U64(0);
+
+		if constexpr (Shift > 0)
+		{
+			return (x & mask) << Shift;
+		}
+		else
+		{
+			return (x & mask) >> -Shift;
+		}
+	}
+
+	// attacks of all knights or pawns in a set
 	static U64 knightAttacks(U64 knightSet);
-	static U64 rayAttacks(U64 set, U64 empty, int shift);
-	static U64 pawnDirAttacks(U64 pawnSet, int color, int shift);
 	static U64 pawnAnyAttacks(U64 pawnSet, int color);
 
-	// other bitboard algorithms
-	static U64 dirFill(U64 set, int shift, bool excludeOriginal);
+	// attacks of a single king or knight on a square
+	static U64 kingAttacksFrom(int square) { return kingAttackTable[square]; }
+	static U64 knightAttacksFrom(int square) { return knightAttackTable[square]; }
+
+	// squares strictly in between two aligned squares and the full line through them (0 if not aligned)
+	static U64 between(int from, int to) { return betweenTable[from][to]; }
+	static U64 line(int from, int to) { return lineTable[from][to]; }
+
+	// fill set in a vertical direction from the taken squares (Kogge-Stone algorithm)
+	template <int Shift>
+	static constexpr U64 dirFill(U64 set, bool excludeOriginal)
+	{
+		static_assert(Shift == NORTH || Shift == SOUTH, "only vertical fills are supported");
+
+		set |= shift<Shift>(set);
+		set |= shift<2 * Shift>(set);
+		set |= shift<4 * Shift>(set);
+		return excludeOriginal ? shift<Shift>(set) : set;
+	}
+
+	// fill files of taken squares
 	static U64 fileFill(U64 set);
 };
\ No newline at end of file
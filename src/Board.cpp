@@ -10,9 +10,7 @@ void Board::loadFromFen(std::string fen)
 	normalStart = (fen == startPosition);
 
 	// reset move history
-	previousInfo = std::stack<PositionalInfo>();
-	previousPositions.clear();
-	moveHistory.clear();
+	ply = 0;
 
 	// split fen into a string array
 	std::array<std::string, 6> splitFen;
@@ -37,9 +35,11 @@ void Board::loadFromFen(std::string fen)
 	for (int i = 0; i < 12; i++)
 	{
 		piecesBB[i] = U64(0);
-		pieceLists[i] = PieceList();
 	}
 	takenBB = U64(0);
+	checkInfoValid = false;
+	materialKey = 0;
+	materialOverflow = 0;
     colorBB[0] = U64(0);
 	colorBB[1] = U64(0);
 	zobrist.reset();
@@ -237,8 +237,7 @@ void Board::movePiece(int piece, int from, int to)
 	piecesMB[from] = EMPTY;
 	piecesMB[to] = piece;
 
-	// update piece list and zobrist key
-	pieceLists[piece].move(from, to);
+	// update zobrist key
 	zobrist.movePiece(piece, from, to);
 }
 
@@ -256,9 +255,12 @@ void Board::addPiece(int piece, int square)
 	// update mailbox based on piece
 	piecesMB[square] = piece;
 
-	// update piece list and zobrist key
-	pieceLists[piece].add(square);
+	// update zobrist key
 	zobrist.changePiece(piece, square);
+
+	// update material key
+	materialKey += Material::keyWeight(piece);
+	materialOverflow += BB::popCount(piecesBB[piece]) == Material::maxCount(piece) + 1;
 }
 
 // remove piece from the board
@@ -275,9 +277,12 @@ void Board::removePiece(int piece, int square)
 	// update mailbox based on piece
 	piecesMB[square] = EMPTY;
 
-	// update piece list and zobrist key
-	pieceLists[piece].remove(square);
+	// update zobrist key
 	zobrist.changePiece(piece, square);
+
+	// update material key
+	materialKey -= Material::keyWeight(piece);
+	materialOverflow -= BB::popCount(piecesBB[piece]) == Material::maxCount(piece);
 }
 
 void Board::rookChanged(int square)
@@ -312,13 +317,62 @@ void Board::rookChanged(int square)
 	}
 }
 
+// use a state stack, a copied board gets its own stack this way before it makes moves
+void Board::setStateStack(std::vector<StateInfo>& stack)
+{
+	if (&stack == states)
+	{
+		statesOwner = this;
+		return;
+	}
+
+	// the stack always needs room for the state of the current ply
+	if ((int)stack.size() <= ply)
+	{
+		stack.resize(std::max(ply * 2, 1024));
+	}
+
+	// copy the states of the previous plies for unmaking moves and repetition detection
+	if (states != nullptr)
+	{
+		std::copy(states->begin(), states->begin() + ply, stack.begin());
+	}
+
+	states = &stack;
+	statesOwner = this;
+}
+
 // make a given move
 void Board::makeMove(Move move)
 {
-	// save current information in the stack
-	PositionalInfo info = { castlingRights, enPassantSquare, halfMoveClock };
-	previousInfo.push(info);
-	previousPositions.push_back(zobrist.getHashKey());
+	// a copied board without its own stack would overwrite the history of the original
+	if (statesOwner != this)
+	{
+		throw std::logic_error("Board has no state stack of its own");
+	}
+
+	checkInfoValid = false;
+
+	int from = move.getFrom();
+	int to = move.getTo();
+	int piece = piecesMB[from];
+	int cPiece = getCapturedPiece(move);
+
+	// save current information, the move and the captured piece in the stack (eval terms are saved by the evaluation)
+	StateInfo& info = (*states)[ply];
+	info.castlingRights = castlingRights;
+	info.enPassantSquare = enPassantSquare;
+	info.halfMoveClock = halfMoveClock;
+	info.zobristKey = zobrist.getHashKey();
+	info.move = move;
+	info.capturedPiece = cPiece;
+
+	// grow the stack in very long games
+	ply++;
+	if (ply == (int)states->size())
+	{
+		states->resize(states->size() * 2);
+	}
 
 	// handle null moves
 	if (Move::isNull(move))
@@ -340,54 +394,53 @@ void Board::makeMove(Move move)
 			moveCount++;
 		}
 
-		moveHistory.push_back(move);
 		return;
 	}
 
-	int pieceType = Piece::typeOf(move.piece);
-	int pieceColor = Piece::colorOf(move.piece);
+	int pieceType = Piece::typeOf(piece);
+	int pieceColor = Piece::colorOf(piece);
 
 	// update captured piece if there is one (and it's not en passant)
-	if ((move.cPiece != EMPTY) && (!move.enPassant))
+	if ((cPiece != EMPTY) && (!move.isEnPassant()))
 	{
-		removePiece(move.cPiece, move.to);
+		removePiece(cPiece, to);
 	}
 
-	movePiece(move.piece, move.from, move.to);
+	movePiece(piece, from, to);
 
-	if (move.enPassant)
+	if (move.isEnPassant())
 	{
 		// if move is en passant calculate the square of enemy pawn and remove it
-		int capturedSquare = move.to + ((pieceColor == WHITE) ? SOUTH : NORTH);
-		removePiece(move.cPiece, capturedSquare);
+		int capturedSquare = to + ((pieceColor == WHITE) ? SOUTH : NORTH);
+		removePiece(cPiece, capturedSquare);
 	}
 
 	// handle rook movement while castling
-	if (move.castling)
+	if (move.isCastling())
 	{
 		// calculate from and to squares of rook
-		bool queenside = Square::fileOf(move.to) == 2;
-		int rank = Square::rankOf(move.from) * 8;
+		bool queenside = Square::fileOf(to) == 2;
+		int rank = Square::rankOf(from) * 8;
 		int rookFrom = rank + (queenside ? 0 : 7);
 		int rookTo = rank + (queenside ? 3 : 5);
 
 		movePiece(piecesMB[rookFrom], rookFrom, rookTo);
 	}
 
-	if (move.promotion != EMPTY)
+	if (move.isPromotion())
 	{
-		removePiece(move.piece, move.to);
-		addPiece(move.promotion, move.to);
+		removePiece(piece, to);
+		addPiece(move.getPromotionType() + pieceColor, to);
 	}
 
 	// remove castling rights if rook was moved/captured
 	if (pieceType == ROOK)
 	{
-		rookChanged(move.from);
+		rookChanged(from);
 	}
-	if (Piece::typeOf(move.cPiece) == ROOK)
+	if (Piece::typeOf(cPiece) == ROOK)
 	{
-		rookChanged(move.to);
+		rookChanged(to);
 	}
 
 	// remove castling rights upon king movement
@@ -408,7 +461,7 @@ void Board::makeMove(Move move)
 	}
 
 	// if pawn was moved two squares, save en passant square
-	if (std::abs(move.to - move.from) == 16 && pieceType == PAWN)
+	if (std::abs(to - from) == 16 && pieceType == PAWN)
 	{
 		if (enPassantSquare != -1)
 		{
@@ -417,7 +470,7 @@ void Board::makeMove(Move move)
 		}
 
 		// save en passant square
-		enPassantSquare = (move.to + move.from) / 2;
+		enPassantSquare = (to + from) / 2;
 
 		// change current en passant square in zobrist key
 		zobrist.changeEnPassant(Square::fileOf(enPassantSquare));
@@ -434,7 +487,7 @@ void Board::makeMove(Move move)
 	}
 
 	// increase half move clock if no pawn move or capture, else reset it
-	if (Piece::typeOf(move.piece) != PAWN && move.cPiece == EMPTY)
+	if (pieceType != PAWN && cPiece == EMPTY)
 	{
 		halfMoveClock++;
 	}
@@ -450,16 +503,16 @@ void Board::makeMove(Move move)
 	{
 		moveCount++;
 	}
-
-	moveHistory.push_back(move);
 }
 
 // unmake a given move
 void Board::unmakeMove(Move move)
 {
+	checkInfoValid = false;
+
 	// get information before this move
-	PositionalInfo lastInfo = previousInfo.top();
-	previousInfo.pop();
+	ply--;
+	StateInfo& lastInfo = (*states)[ply];
 
 	// load information
 	for (int i = 0; i < 4; i++)
@@ -479,45 +532,46 @@ void Board::unmakeMove(Move move)
 		}
 
 		// set zobrist key to previous position
-		zobrist.set(previousPositions.back());
-		previousPositions.pop_back();
-
-		moveHistory.pop_back();
+		zobrist.set(lastInfo.zobristKey);
 
 		return;
 	}
 
-	int pieceType = Piece::typeOf(move.piece);
-	bool pieceColor = Piece::colorOf(move.piece);
+	int from = move.getFrom();
+	int to = move.getTo();
+	int cPiece = lastInfo.capturedPiece;
+	bool pieceColor = !turnColor;
+	int piece = piecesMB[to];
 
 	// if it's a promotion remove promotion piece, add pawn
-	if (move.promotion != EMPTY)
+	if (move.isPromotion())
 	{
-		removePiece(move.promotion, move.to);
-		addPiece(move.piece, move.to);
+		removePiece(piece, to);
+		piece = PAWN + pieceColor;
+		addPiece(piece, to);
 	}
 
-	movePiece(move.piece, move.to, move.from);
+	movePiece(piece, to, from);
 
 	// add captured piece if there is one
-	if ((move.cPiece != EMPTY) && (!move.enPassant))
+	if ((cPiece != EMPTY) && (!move.isEnPassant()))
 	{
-		addPiece(move.cPiece, move.to);
+		addPiece(cPiece, to);
 	}
 
-	if (move.enPassant)
+	if (move.isEnPassant())
 	{
 		// if move is en passant calculate square of captured pawn and add it
-		int capturedSquare = move.to + ((pieceColor == WHITE) ? SOUTH : NORTH);
-		addPiece(move.cPiece, capturedSquare);
+		int capturedSquare = to + ((pieceColor == WHITE) ? SOUTH : NORTH);
+		addPiece(cPiece, capturedSquare);
 	}
 
 	// handle rook movement while castling
-	if (move.castling)
+	if (move.isCastling())
 	{
 		// calculate the from and to squares of the rook
-		bool queenside = Square::fileOf(move.to) == 2;
-		int rank = Square::rankOf(move.from) * 8;
+		bool queenside = Square::fileOf(to) == 2;
+		int rank = Square::rankOf(from) * 8;
 		int rookFrom = rank + (queenside ? 0 : 7);
 		int rookTo = rank + (queenside ? 3 : 5);
 
@@ -531,230 +585,525 @@ void Board::unmakeMove(Move move)
 	}
 
 	// set zobrist key to previous position
-	zobrist.set(previousPositions.back());
-	previousPositions.pop_back();
+	zobrist.set(lastInfo.zobristKey);
+}
 
-	moveHistory.pop_back();
+// add a move to every target of a bitboard, the source is a fixed offset away from the target
+template <int Offset, int Flag = NORMAL_MOVE>
+static void addShiftedMoves(MoveList& moveList, U64 targets)
+{
+	for (; targets != 0; targets &= targets - 1)
+	{
+		int target = BB::bitScanForward(targets);
+		moveList.add(Move(target - Offset, target, Flag));
+	}
 }
 
-// generate all moves with DirGolem
-void Board::generateMoves(bool onlyCaptures)
+// add pawn moves to every target of a bitboard, moves to the promotion rank are added for every promotion piece
+template <int Offset>
+static void addPawnMoves(MoveList& moveList, U64 targets, U64 promotionRank)
 {
-	int color = turnColor;
-	int eColor = 1 - color;
+	for (U64 promotions = targets & promotionRank; promotions != 0; promotions &= promotions - 1)
+	{
+		int target = BB::bitScanForward(promotions);
+		for (int piece : {QUEEN, ROOK, BISHOP, KNIGHT})
+		{
+			moveList.add(Move(target - Offset, target, PROMOTION_MOVE, piece));
+		}
+	}
 
-	// save bitboards of squares in between of attacker and king; 0 - horizontal, 1 - vertical, 2 - diagonal, 3 - antidiagonal; to calculate pins
-	std::array<U64, 4> inBetween = { U64(0), U64(0), U64(0), U64(0) };
+	addShiftedMoves<Offset>(moveList, targets & ~promotionRank);
+}
+
+// add a move from the source to every target of a bitboard
+static void addMoves(MoveList& moveList, int source, U64 targets)
+{
+	for (; targets != 0; targets &= targets - 1)
+	{
+		moveList.add(Move(source, BB::bitScanForward(targets)));
+	}
+}
+
+// restrict the targets of a piece to squares where it gives check, either directly or by uncovering a slider
+static U64 checkingTargets(const CheckInfo& info, int source, int piece, U64 targets)
+{
+	U64 checks = info.checkSquares[piece];
+	if (info.discoveredCandidates & (U64(1) << source))
+	{
+		checks |= ~BB::line(source, info.enemyKingSquare);
+	}
+
+	return targets & checks;
+}
+
+// generate moves based on position into the given list, dispatched once to the generator of the turn color and generation type
+void Board::generateMoves(MoveList& moveList, int genType)
+{
+	if (turnColor == WHITE)
+	{
+		switch (genType)
+		{
+		case CAPTURES:
+			generateMoves<WHITE, CAPTURES>(moveList);
+			break;
+		case QUIETS:
+			generateMoves<WHITE, QUIETS>(moveList);
+			break;
+		case EVASIONS:
+			generateMoves<WHITE, EVASIONS>(moveList);
+			break;
+		case QUIET_CHECKS:
+			generateMoves<WHITE, QUIET_CHECKS>(moveList);
+			break;
+		default:
+			generateMoves<WHITE, ALL_MOVES>(moveList);
+		}
+	}
+	else
+	{
+		switch (genType)
+		{
+		case CAPTURES:
+			generateMoves<BLACK, CAPTURES>(moveList);
+			break;
+		case QUIETS:
+			generateMoves<BLACK, QUIETS>(moveList);
+			break;
+		case EVASIONS:
+			generateMoves<BLACK, EVASIONS>(moveList);
+			break;
+		case QUIET_CHECKS:
+			generateMoves<BLACK, QUIET_CHECKS>(moveList);
+			break;
+		default:
+			generateMoves<BLACK, ALL_MOVES>(moveList);
+		}
+	}
+}
+
+// generate legal moves of one color, sliding attacks are looked up in magic bitboard tables
+// pawn directions, promotion ranks, castling squares and the capture filter are compile-time constants
+template <int Color, int Type>
+void Board::generateMoves(MoveList& moveList)
+{
+	constexpr bool genCaptures = (Type != QUIETS && Type != QUIET_CHECKS);
+	constexpr bool genQuiets = (Type != CAPTURES);
+	constexpr bool genCastling = (Type != CAPTURES && Type != EVASIONS);
 
-	// save bitboards of rays coming from king; 0 - orthogonal, 1 - diagonal; to calculate pieces giving check
-	std::array<U64, 2> superAttacks = { U64(0), U64(0) };
+	constexpr int eColor = 1 - Color;
+	constexpr int pawnDir = (Color == WHITE) ? NORTH : SOUTH;
+	constexpr int westCapture = pawnDir + WEST;
+	constexpr int eastCapture = pawnDir + EAST;
+	constexpr U64 rank4 = (Color == WHITE) ? U64(0x000000FF00000000) : U64(0x00000000FF000000);
+	constexpr U64 promotionRank = (Color == WHITE) ? U64(0x00000000000000FF) : U64(0xFF00000000000000);
+	constexpr int kingStart = (Color == WHITE) ? 60 : 4;
 
-	// save bitboard of all attacks of other color; to calculate squares in check
-	U64 anyAttacks = U64(0);
+	// index of the pin line of each pawn capture (2 - diagonal, 3 - antidiagonal)
+	constexpr int westLine = (Color == WHITE) ? 3 : 2;
+	constexpr int eastLine = 5 - westLine;
 
-	// create bitboard of empty squares
-	U64 empty = ~takenBB;
+	int kingSquare = BB::bitScanForward(piecesBB[KING + Color]);
+
+	// save bitboards of squares in between of attacker and king; 0 - horizontal, 1 - vertical, 2 - diagonal, 3 - antidiagonal; to calculate pins
+	std::array<U64, 4> inBetween = { U64(0), U64(0), U64(0), U64(0) };
 
 	// first - obtain information from the enemy color's moves for checks and pins
 
-	// loop through 8 main directions
-	for (int i = 0; i < 8; i++)
-	{
-		U64 attacks, kingSuperAttacks;
+	// enemy orthogonal and diagonal sliders (queens count as both)
+	U64 enemyRooks = piecesBB[ROOK + eColor] | piecesBB[QUEEN + eColor];
+	U64 enemyBishops = piecesBB[BISHOP + eColor] | piecesBB[QUEEN + eColor];
 
-		// save additional attacking piece besides queen (rook if direction is orthogonal, bishop if diagonal)
-		U64 additionalPieces = (i < 4) ? piecesBB[ROOK + eColor] : piecesBB[BISHOP + eColor];
+	// save attacks of sliding pieces, while excluding king from taken squares
+	U64 takenWithoutKing = takenBB ^ piecesBB[KING + Color];
+	U64 anyAttacks = Magic::rookSetAttacks(enemyRooks, takenWithoutKing) | Magic::bishopSetAttacks(enemyBishops, takenWithoutKing);
 
-		// save attacks of these "ray pieces", while excluding king from empty set
-		attacks = BB::rayAttacks(additionalPieces | piecesBB[QUEEN + eColor], empty ^ piecesBB[KING + color], dirs[i]);
-		anyAttacks |= attacks;
+	// sliders which are aligned to the king with at most one piece in between either give check or pin that piece
+	U64 aligned = (Magic::rookAttacks(kingSquare, U64(0)) & enemyRooks) | (Magic::bishopAttacks(kingSquare, U64(0)) & enemyBishops);
+	for (; aligned != 0; aligned &= aligned - 1)
+	{
+		int slider = BB::bitScanForward(aligned);
+		U64 between = BB::between(kingSquare, slider);
 
-		// calculate attacks from the king in the opposite direction
-		kingSuperAttacks = BB::rayAttacks(piecesBB[KING + color], empty, -dirs[i]);
+		U64 blockers = between & takenBB;
 
-		// add these "super attacks" to the specific super attack bitboard
-		superAttacks[i / 4] |= kingSuperAttacks;
+		if (BB::popCount(blockers) <= 1)
+		{
+			// get the direction of the line between king and slider
+			int fileDiff = Square::fileOf(slider) - Square::fileOf(kingSquare);
+			int rankDiff = Square::rankOf(slider) - Square::rankOf(kingSquare);
+			int lineIndex = (rankDiff == 0) ? 0 : (fileDiff == 0) ? 1 : (fileDiff == -rankDiff) ? 2 : 3;
 
-		// add the intersection between sliding attacks and king attacks to the in between bitboard
-		inBetween[i / 2] |= attacks & kingSuperAttacks;
+			// save the squares between on a check, save the pinned piece on a pin
+			inBetween[lineIndex] |= (blockers == 0) ? between : blockers;
+		}
 	}
-	
+
 	// enemy knight, pawn and king attacks
 	anyAttacks |= BB::knightAttacks(piecesBB[KNIGHT + eColor]);
 	anyAttacks |= BB::pawnAnyAttacks(piecesBB[PAWN + eColor], eColor);
-	anyAttacks |= BB::kingAttacks(piecesBB[KING + eColor]);
+	anyAttacks |= BB::kingAttacksFrom(BB::bitScanForward(piecesBB[KING + eColor]));
 
 	U64 allInbetween = inBetween[0] | inBetween[1] | inBetween[2] | inBetween[3];
 
-	// calculate squares that could block a check
-	U64 blocks = allInbetween & ~takenBB;
+	// calculate pieces where the check is from by looking up attacks from the king square
+	U64 checkFrom = (Magic::rookAttacks(kingSquare, takenBB) & enemyRooks)
+		| (Magic::bishopAttacks(kingSquare, takenBB) & enemyBishops)
+		| (BB::knightAttacksFrom(kingSquare) & piecesBB[KNIGHT + eColor])
+		| (BB::pawnAnyAttacks(piecesBB[KING + Color], Color) & piecesBB[PAWN + eColor]);
 
-	// calculate pieces where the check is from by intersecting super attacks of the king with the enemy color's pieces
-	U64 checkFrom = (superAttacks[0] & (piecesBB[ROOK + eColor] | piecesBB[QUEEN + eColor]))
-		| (superAttacks[1] & (piecesBB[BISHOP + eColor] | piecesBB[QUEEN + eColor]))
-		| (BB::knightAttacks(piecesBB[KING + color]) & piecesBB[KNIGHT + eColor])
-		| (BB::pawnAnyAttacks(piecesBB[KING + color], color) & piecesBB[PAWN + eColor]);
+	isCheck = (anyAttacks & piecesBB[KING + Color]) != 0;
+	bool doubleCheck = (checkFrom & (checkFrom - 1)) != 0;
 
-	// save null if it's a check or if it's a double check by using signed shifts to avoid branches
-	I64 nullIfCheck = ((I64)(anyAttacks & piecesBB[KING + color]) - 1) >> 63;
-	I64 nullIfDblCheck = ((I64)(checkFrom & (checkFrom - 1)) - 1) >> 63;
+	// get squares where the turn color's pieces can move to avoid checks (capture the checker or block the check)
+	U64 checkTo = isCheck ? (checkFrom | (allInbetween & ~takenBB)) : ~U64(0);
 
-	isCheck = nullIfCheck == 0;
+	// create capture mask based on whether generation is capture or quiet only
+	constexpr U64 allSquares = ~U64(0);
+	U64 captureMask = !genQuiets ? colorBB[eColor] : !genCaptures ? ~takenBB : allSquares;
 
-	// get pieces where the turn color's pieces can move to avoid checks
-	U64 checkTo = checkFrom | blocks | nullIfCheck;
+	// create a target mask for all pieces but the king, only the king can move on a double check
+	U64 targetMask = doubleCheck ? U64(0) : ~colorBB[Color] & checkTo & captureMask;
+	U64 kingTargets = BB::kingAttacksFrom(kingSquare) & ~(colorBB[Color] | anyAttacks) & captureMask;
 
-	// create capture mask based on whether generation is capture only
-	U64 nullIfCaptures = ~U64(0) * !onlyCaptures;
-	U64 captureMask = nullIfCaptures | colorBB[eColor];
-	
-	// save move targets for every direction and create a target mask for all moves
-	std::array<U64, 16> moveTargets = { U64(0), U64(0), U64(0), U64(0), U64(0), U64(0), U64(0), U64(0), U64(0), U64(0), U64(0), U64(0), U64(0), U64(0), U64(0), U64(0)};
-	U64 targetMask = ~colorBB[color] & checkTo & nullIfDblCheck & captureMask;
+	moveList.clear();
 
-	// loop through 4 directions (horizontal, vertical, diagonal, antidiagonal)
-	for (int i = 0; i < 4; i++)
+	// evasions on a double check are king moves only
+	if constexpr (Type == EVASIONS)
+	{
+		if (doubleCheck)
+		{
+			addMoves(moveList, kingSquare, kingTargets);
+			return;
+		}
+	}
+
+	// quiet checks are restricted to the squares where a piece checks the enemy king
+	const CheckInfo* info = (Type == QUIET_CHECKS) ? &getCheckInfo() : nullptr;
+
+	// generate moves of sliders directly from their attacks, pinned sliders may only move on the line of the pin
+	for (U64 sliders = piecesBB[ROOK + Color] | piecesBB[QUEEN + Color]; sliders != 0; sliders &= sliders - 1)
 	{
-		// get additional piece (bishop or rook) based on direction
-		U64 additionalPieces = (i < 2) ? piecesBB[ROOK + color] : piecesBB[BISHOP + color];
+		int source = BB::bitScanForward(sliders);
+		U64 targets = Magic::rookAttacks(source, takenBB) & targetMask;
+		if (allInbetween & (U64(1) << source))
+		{
+			targets &= BB::line(kingSquare, source);
+		}
+		if constexpr (Type == QUIET_CHECKS)
+		{
+			targets = checkingTargets(*info, source, piecesMB[source], targets);
+		}
 
-		// calculate sliders which aren't pinned not in this direction
-		U64 sliders = (additionalPieces | piecesBB[color + QUEEN]) & ~(allInbetween ^ inBetween[i]);
+		addMoves(moveList, source, targets);
+	}
+
+	for (U64 sliders = piecesBB[BISHOP + Color] | piecesBB[QUEEN + Color]; sliders != 0; sliders &= sliders - 1)
+	{
+		int source = BB::bitScanForward(sliders);
+		U64 targets = Magic::bishopAttacks(source, takenBB) & targetMask;
+		if (allInbetween & (U64(1) << source))
+		{
+			targets &= BB::line(kingSquare, source);
+		}
+		if constexpr (Type == QUIET_CHECKS)
+		{
+			targets = checkingTargets(*info, source, piecesMB[source], targets);
+		}
 
-		// add attacks of these sliders to the target array after applying target mask
-		moveTargets[i * 2] = BB::rayAttacks(sliders, empty, dirs[i * 2]) & targetMask;
-		moveTargets[i * 2 + 1] = BB::rayAttacks(sliders, empty, dirs[i * 2 + 1]) & targetMask;
+		addMoves(moveList, source, targets);
 	}
-	
-	// get knights which aren't pinned and calculate moves in the knights' 8 directions
-	U64 knights = piecesBB[color + KNIGHT] & ~allInbetween;
-	for (int i = 8; i < 16; i++)
+
+	// generate moves of knights which aren't pinned
+	for (U64 knights = piecesBB[KNIGHT + Color] & ~allInbetween; knights != 0; knights &= knights - 1)
 	{
-		moveTargets[i] = BB::shiftTwo(knights, dirs[i]) & targetMask;
+		int source = BB::bitScanForward(knights);
+		U64 targets = BB::knightAttacksFrom(source) & targetMask;
+		if constexpr (Type == QUIET_CHECKS)
+		{
+			targets = checkingTargets(*info, source, KNIGHT + Color, targets);
+		}
+
+		addMoves(moveList, source, targets);
 	}
-	
-	int pawnDir = color == WHITE ? NORTH : SOUTH;
-	int pawnDirIndex = dirToIndex[pawnDir];
 
-	// target bitboard for pawns based on enemy pieces
-	U64 targets = colorBB[eColor] & targetMask;
-	U64 pawns;
+	U64 pawns = piecesBB[PAWN + Color];
 
-	for (int dir : {WEST, EAST})
+	if constexpr (genCaptures)
 	{
-		// add pawn attacks in east and west of pawns which aren't pinned in that direction
-		pawns = piecesBB[color + PAWN] & ~(allInbetween ^ inBetween[dirToIndex[pawnDir + dir] / 2]);
-		moveTargets[dirToIndex[pawnDir + dir]] |= BB::shiftTwo(pawns, pawnDir + dir) & targets;
+		// add pawn captures in east and west of pawns which aren't pinned in that direction
+		U64 targets = colorBB[eColor] & targetMask;
+		addPawnMoves<westCapture>(moveList, BB::shift<westCapture>(pawns & ~(allInbetween ^ inBetween[westLine])) & targets, promotionRank);
+		addPawnMoves<eastCapture>(moveList, BB::shift<eastCapture>(pawns & ~(allInbetween ^ inBetween[eastLine])) & targets, promotionRank);
+
+		if (enPassantSquare != -1)
+		{
+			// get taken square bitboard without pawn which is attacked by en passant
+			U64 takenWithoutPawn = takenBB ^ (U64(1) << (enPassantSquare - pawnDir));
+			U64 kingRank = U64(0xFF) << (Square::rankOf(kingSquare) * 8);
+			U64 inBetweenHor = U64(0);
+
+			// get horizontal enemy queen and rook attacks, get attacks from the king, save intersection
+			U64 kingAttacks = Magic::rookAttacks(kingSquare, takenWithoutPawn) & kingRank;
+			for (U64 sliders = enemyRooks & kingRank; sliders != 0; sliders &= sliders - 1)
+			{
+				inBetweenHor |= Magic::rookAttacks(BB::bitScanForward(sliders), takenWithoutPawn) & kingAttacks;
+			}
+
+			// only make the move possible if the en passant pawn is a target
+			targets = BB::shift<pawnDir>(U64(1) << (enPassantSquare - pawnDir) & targetMask);
+
+			// add en passant captures of pawns which aren't pinned in that direction
+			U64 epPawns = pawns & ~inBetweenHor;
+			addShiftedMoves<westCapture, EN_PASSANT_MOVE>(moveList, BB::shift<westCapture>(epPawns & ~(allInbetween ^ inBetween[westLine])) & targets);
+			addShiftedMoves<eastCapture, EN_PASSANT_MOVE>(moveList, BB::shift<eastCapture>(epPawns & ~(allInbetween ^ inBetween[eastLine])) & targets);
+		}
 	}
- 
-	// add pawn pushes and double pawn pushes for pawns that aren't pinned not vertically
-	pawns = piecesBB[color + PAWN] & ~(allInbetween ^ inBetween[1]);
-	U64 pawnPushes = BB::shiftTwo(pawns, pawnDir) & ~takenBB;
-	moveTargets[pawnDirIndex] |= pawnPushes & targetMask;
-	
-	U64 rank4 = color == WHITE ? U64(0x000000FF00000000) : U64(0x00000000FF000000);
-	moveTargets[pawnDirIndex] |= BB::shiftTwo(pawnPushes, pawnDir) & ~takenBB & targetMask & rank4;
 
-	if (enPassantSquare != -1)
+	if constexpr (genQuiets)
 	{
-		// get empty square bitboard without pawn which is attacked by en passant
-		U64 emptyWithoutPawn = ~(takenBB ^ (U64(1) << (enPassantSquare - pawnDir)));
-		U64 inBetweenHor = U64(0);
+		// add pawn pushes and double pawn pushes for pawns that aren't pinned not vertically
+		U64 pawnPushes = BB::shift<pawnDir>(pawns & ~(allInbetween ^ inBetween[1])) & ~takenBB;
+		U64 pushTargets = pawnPushes & targetMask;
+		U64 doublePushTargets = BB::shift<pawnDir>(pawnPushes) & ~takenBB & targetMask & rank4;
 
-		for (int dir : {WEST, EAST})
+		if constexpr (Type == QUIET_CHECKS)
 		{
-			// get horizontal enemy queen and rook attacks, get attacks in opposite direction of king, save intersection
-			U64 attacks = BB::rayAttacks(piecesBB[ROOK + eColor] | piecesBB[QUEEN + eColor], emptyWithoutPawn, dir);
-			U64 superAttacks = BB::rayAttacks(piecesBB[KING + color], emptyWithoutPawn, -dir);
-			inBetweenHor |= attacks & superAttacks;
+			// pushes check directly or uncover a slider if the pawn isn't on the file of the enemy king
+			U64 discoverers = pawns & info->discoveredCandidates & ~(U64(0x0101010101010101) << Square::fileOf(info->enemyKingSquare));
+			U64 checks = info->checkSquares[PAWN + Color];
+
+			// quiet promotions are checked one by one, as the promoted piece determines the check
+			for (U64 promotions = pushTargets & promotionRank; promotions != 0; promotions &= promotions - 1)
+			{
+				int target = BB::bitScanForward(promotions);
+				for (int piece : {QUEEN, ROOK, BISHOP, KNIGHT})
+				{
+					Move move(target - pawnDir, target, PROMOTION_MOVE, piece);
+					if (givesCheck(move))
+					{
+						moveList.add(move);
+					}
+				}
+			}
+
+			pushTargets &= ~promotionRank & (checks | BB::shift<pawnDir>(discoverers));
+			doublePushTargets &= checks | BB::shift<2 * pawnDir>(discoverers);
 		}
 
-		// only make the move possible if the en passant pawn is a target
-		targets = U64(1) << (enPassantSquare - pawnDir) & targetMask;
-		targets = BB::genShift(targets, pawnDir);
+		addPawnMoves<pawnDir>(moveList, pushTargets, promotionRank);
+		addShiftedMoves<2 * pawnDir>(moveList, doublePushTargets);
+	}
+
+	// move king to all neighbouring squares which aren't attacked
+	if constexpr (Type == QUIET_CHECKS)
+	{
+		kingTargets = checkingTargets(*info, kingSquare, KING + Color, kingTargets);
+	}
+	addMoves(moveList, kingSquare, kingTargets);
 
-		for (int dir : {WEST, EAST})
+	// castle if not in check, castling rights aren't taken and the squares between king and rook are free and not attacked
+	if constexpr (genCastling)
+	{
+		if (!isCheck && kingSquare == kingStart)
 		{
-			// add pawn attacks in east and west of pawns which aren't pinned in that direction
-			pawns = piecesBB[color + PAWN] & ~inBetweenHor & ~(allInbetween ^ inBetween[dirToIndex[pawnDir + dir] / 2]);
-			moveTargets[dirToIndex[pawnDir + dir]] |= BB::shiftTwo(pawns, pawnDir + dir) & targets;
+			constexpr U64 eastPath = U64(0x3) << (kingStart + 1);
+			constexpr U64 westPath = U64(0x3) << (kingStart - 2);
+			constexpr U64 westRookPath = U64(0x1) << (kingStart - 3);
+
+			Move eastCastle(kingStart, kingStart + 2, CASTLING_MOVE);
+			Move westCastle(kingStart, kingStart - 2, CASTLING_MOVE);
+
+			if (castlingRights[Color * 2] && !(eastPath & (takenBB | anyAttacks)) && (Type != QUIET_CHECKS || givesCheck(eastCastle)))
+			{
+				moveList.add(eastCastle);
+			}
+			if (castlingRights[Color * 2 + 1] && !(westPath & (takenBB | anyAttacks)) && !(westRookPath & takenBB) && (Type != QUIET_CHECKS || givesCheck(westCastle)))
+			{
+				moveList.add(westCastle);
+			}
 		}
 	}
+}
+
+// get pieces of both colors attacking a square with given occupancy
+U64 Board::attackersTo(int square, U64 occupied)
+{
+	U64 squareBB = U64(1) << square;
+
+	return (Magic::rookAttacks(square, occupied) & (piecesBB[WHITE + ROOK] | piecesBB[BLACK + ROOK] | piecesBB[WHITE + QUEEN] | piecesBB[BLACK + QUEEN]))
+		| (Magic::bishopAttacks(square, occupied) & (piecesBB[WHITE + BISHOP] | piecesBB[BLACK + BISHOP] | piecesBB[WHITE + QUEEN] | piecesBB[BLACK + QUEEN]))
+		| (BB::knightAttacksFrom(square) & (piecesBB[WHITE + KNIGHT] | piecesBB[BLACK + KNIGHT]))
+		| (BB::kingAttacksFrom(square) & (piecesBB[WHITE + KING] | piecesBB[BLACK + KING]))
+		| (BB::pawnAnyAttacks(squareBB, BLACK) & piecesBB[WHITE + PAWN])
+		| (BB::pawnAnyAttacks(squareBB, WHITE) & piecesBB[BLACK + PAWN]);
+}
+
+// check if the moved piece can make a move (e. g. from the transposition table) in the current position, ignoring checks to the own king
+bool Board::isPseudoLegal(Move move)
+{
+	int color = turnColor;
+	int eColor = 1 - color;
+	int from = move.getFrom();
+	int to = move.getTo();
+	int piece = piecesMB[from];
+	int cPiece = getCapturedPiece(move);
 
-	// move king in all possible directions which aren't attacked
-	targetMask = ~(colorBB[color] | anyAttacks) & captureMask;
-	U64 king = piecesBB[color + KING];
-	for (int i = 0; i < 8; i++)
+	if (Move::isNull(move) || piece == EMPTY || Piece::colorOf(piece) != color || (cPiece != EMPTY && Piece::colorOf(cPiece) != eColor))
 	{
-		moveTargets[i] |= BB::shiftTwo(king, dirs[i]) & targetMask;
+		return false;
 	}
 
-	// don't castle if in check
-	king &= nullIfCheck;
+	// the move flag has to match the one the board would give this move (promotion pieces can be any)
+	if (Move::loadFromSquares(from, to, *this).getFlag() != move.getFlag())
+	{
+		return false;
+	}
 
-	// check if spaces between king and rook are taken or in check and that castling rights aren't taken, if not add castles
-	targetMask = ~(takenBB | anyAttacks);
-	U64 eastCastle = BB::shiftTwo(king, EAST) & targetMask & (~U64(0) * ((castlingRights[0] && (color == WHITE)) || (castlingRights[2] && (color == BLACK))));
-	moveTargets[0] |= BB::shiftTwo(eastCastle, EAST) & targetMask & captureMask;
-	U64 westCastle = BB::shiftTwo(king, WEST) & targetMask & (~U64(0) * ((castlingRights[1] && (color == WHITE)) || (castlingRights[3] && (color == BLACK))));
-	moveTargets[1] |= BB::shiftTwo(BB::shiftTwo(westCastle, WEST + WEST) & ~takenBB, EAST) & targetMask & captureMask;
-	
-	moveList.clear();
+	U64 fromBB = U64(1) << from;
+	U64 toBB = U64(1) << to;
+	int pieceType = Piece::typeOf(piece);
 
-	// loop through 8 ray directions
-	for (int i = 0; i < 8; i++)
+	// check if the piece can reach the target square
+	switch (pieceType)
+	{
+	case PAWN:
 	{
-		// while there are targets to analyze
-		while (moveTargets[i] != 0)
+		int pawnDir = color == WHITE ? NORTH : SOUTH;
+		if (to == from + pawnDir)
 		{
-			// find the next target and erase it from bitboard
-			int target = BB::bitScanForward(moveTargets[i]);
-			moveTargets[i] ^= U64(1) << target;
-
-			// cast a ray in that direction until a piece is found
-			int source = target - dirs[i];
-			while (piecesMB[source] == EMPTY)
+			if (cPiece != EMPTY)
 			{
-				source -= dirs[i];
+				return false;
 			}
-			
-			// generate move and add it to move list
-			Move move = Move::loadFromSquares(source, target, piecesMB);
-			int pieceColor = Piece::colorOf(piecesMB[source]);
-
-			if (move.promotion != EMPTY)
+		}
+		else if (to == from + 2 * pawnDir)
+		{
+			// double pushes only from the starting rank over an empty square
+			if (Square::rankOf(from) != (color == WHITE ? 6 : 1) || cPiece != EMPTY || piecesMB[from + pawnDir] != EMPTY)
 			{
-				// add all promotion pieces as moves
-				for (int piece : {QUEEN, ROOK, BISHOP, KNIGHT})
-				{
-					move.promotion = piece + pieceColor;
-					moveList.push_back(move);
-				}
+				return false;
 			}
-			else
+		}
+		else if (BB::pawnAnyAttacks(fromBB, color) & toBB)
+		{
+			if (cPiece == EMPTY || (move.isEnPassant() && to != enPassantSquare))
 			{
-				moveList.push_back(move);
+				return false;
 			}
 		}
+		else
+		{
+			return false;
+		}
+		break;
 	}
-	
-	// knight move directions
-	for (int i = 8; i < 16; i++)
-	{
-		// while there are targets
-		while (moveTargets[i] != 0)
+	case KNIGHT:
+		if (!(BB::knightAttacksFrom(from) & toBB))
 		{
-			// get next target and erase it from bitboard
-			int target = BB::bitScanForward(moveTargets[i]);
-			moveTargets[i] ^= U64(1) << target;
-
-			// get the source of the move
-			int source = target - dirs[i];
-			
-			// add move to move list
-			moveList.push_back(Move::loadFromSquares(source, target, piecesMB));
+			return false;
+		}
+		break;
+	case BISHOP:
+		if (!(Magic::bishopAttacks(from, takenBB) & toBB))
+		{
+			return false;
 		}
+		break;
+	case ROOK:
+		if (!(Magic::rookAttacks(from, takenBB) & toBB))
+		{
+			return false;
+		}
+		break;
+	case QUEEN:
+		if (!(Magic::queenAttacks(from, takenBB) & toBB))
+		{
+			return false;
+		}
+		break;
+	case KING:
+		if (move.isCastling())
+		{
+			// castling needs the castling right, empty squares between king and rook and no attacks on the king's path
+			bool queenside = Square::fileOf(to) == 2;
+			int rookSquare = from + (queenside ? -4 : 3);
+			int pathSquare = (from + to) / 2;
+			U64 enemies = colorBB[eColor];
+
+			return castlingRights[color * 2 + queenside] && piecesMB[rookSquare] == ROOK + color && !(BB::between(from, rookSquare) & takenBB)
+				&& !(attackersTo(from, takenBB) & enemies) && !(attackersTo(pathSquare, takenBB) & enemies) && !(attackersTo(to, takenBB) & enemies);
+		}
+		if (!(BB::kingAttacksFrom(from) & toBB))
+		{
+			return false;
+		}
+		break;
+	}
+
+	return true;
+}
+
+// check if a move is legal in the current position, a few bitboard operations for pseudo-legal moves without generating moves
+bool Board::isLegal(Move move)
+{
+	if (!isPseudoLegal(move))
+	{
+		return false;
+	}
+
+	const CheckInfo& info = getCheckInfo();
+
+	int color = turnColor;
+	int from = move.getFrom();
+	int to = move.getTo();
+	U64 fromBB = U64(1) << from;
+	U64 toBB = U64(1) << to;
+	int kingSquare = BB::bitScanForward(piecesBB[KING + color]);
+	bool kingMove = (from == kingSquare);
+
+	// castling has been checked for attacks already
+	if (move.isCastling())
+	{
+		return true;
+	}
+
+	// other moves when not in check are only illegal if a pinned piece leaves the line of its pin
+	if (!kingMove && !move.isEnPassant() && info.checkers == 0)
+	{
+		return !(info.pinned & fromBB) || (BB::line(from, kingSquare) & toBB);
+	}
+
+	// otherwise the king mustn't be attacked after the move, captured pieces can't attack anymore
+	if (kingMove)
+	{
+		kingSquare = to;
+	}
+
+	U64 capturedBB = toBB;
+	if (move.isEnPassant())
+	{
+		capturedBB = U64(1) << (to + (color == WHITE ? SOUTH : NORTH));
+	}
+	U64 occupied = ((takenBB ^ fromBB) & ~capturedBB) | toBB;
+
+	return (attackersTo(kingSquare, occupied) & colorBB[!color] & ~capturedBB) == 0;
+}
+
+// get the piece a move would move in the current position
+int Board::getMovedPiece(Move move)
+{
+	return piecesMB[move.getFrom()];
+}
+
+// get the piece a move would capture in the current position
+int Board::getCapturedPiece(Move move)
+{
+	if (move.isEnPassant())
+	{
+		return PAWN + !turnColor;
 	}
+
+	return piecesMB[move.getTo()];
 }
 
 // check if there's a draw (except stalemate)
@@ -766,52 +1115,23 @@ bool Board::checkDraw()
 		return true;
 	}
 	// end the game on a draw if three-fold repetition
-	else if (std::count(previousPositions.begin(), previousPositions.end(), zobrist.getHashKey()) >= 2)
+	else if (countRepetitions() >= 2)
 	{
 		return true;
 	}
 	// check for insufficient material
 	else
 	{
-		// only check if there aren't any queens, rooks or pawns
-		if (pieceLists[WHITE + QUEEN].getCount() == 0 && pieceLists[BLACK + QUEEN].getCount() == 0 &&
-			(pieceLists[WHITE + ROOK].getCount() == 0 && pieceLists[BLACK + ROOK].getCount() == 0 &&
-				pieceLists[WHITE + PAWN].getCount() == 0 && pieceLists[BLACK + PAWN].getCount() == 0))
+		MaterialEntry material = getMaterialEntry();
+		if (material.draw == DRAWN)
 		{
-			// if there are only two kings, end game on draw
-			if (pieceLists[WHITE + KNIGHT].getCount() == 0 && pieceLists[WHITE + BISHOP].getCount() == 0 &&
-				(pieceLists[BLACK + KNIGHT].getCount() == 0 && pieceLists[BLACK + BISHOP].getCount() == 0))
-			{
-				return true;
-			}
-
-			// get counts for knights and bishops
-			std::array<int, 2> knights = { pieceLists[WHITE + KNIGHT].getCount(), pieceLists[BLACK + KNIGHT].getCount() };
-			std::array<int, 2> bishops = { pieceLists[WHITE + BISHOP].getCount(), pieceLists[BLACK + BISHOP].getCount() };
-
-			// if both colors have one bishop each and there are no other minor pieces, end game on a draw if both bishops are on the same color
-			if (knights[WHITE] == 0 && bishops[WHITE] == 1 && knights[BLACK] == 0 && bishops[BLACK] == 1)
-			{
-				if (Square::isLight(pieceLists[WHITE + BISHOP][0]) == Square::isLight(pieceLists[BLACK + BISHOP][0]))
-				{
-					return true;
-				}
-			}
-
-			for (int col = 0; col < 2; col++)
-			{
-				// if this color has only one knight and there are no other minor pieces, end game on a draw
-				if (knights[col] == 1 && bishops[col] == 0 && knights[!col] == 0 && bishops[!col] == 0)
-				{
-					return true;
-				}
+			return true;
+		}
 
-				// if this color has only one bishop and there are no other minor pieces, end game on a draw
-				if (knights[col] == 0 && bishops[col] == 1 && knights[!col] == 0 && bishops[!col] == 0)
-				{
-					return true;
-				}
-			}
+		// if both colors have one bishop each and there are no other minor pieces, end game on a draw if both bishops are on the same color
+		if (material.draw == DRAWN_IF_SAME_BISHOPS)
+		{
+			return Square::isLight(BB::bitScanForward(piecesBB[WHITE + BISHOP])) == Square::isLight(BB::bitScanForward(piecesBB[BLACK + BISHOP]));
 		}
 	}
 
@@ -819,7 +1139,7 @@ bool Board::checkDraw()
 }
 
 // get state of the game
-int Board::getState()
+int Board::getState(MoveList& moveList)
 {
 	// if no moves are available
 	if (moveList.size() == 0)
@@ -856,7 +1176,59 @@ int Board::getState()
 // check if a position has been repeated once
 bool Board::checkRepetition()
 {
-	return std::count(previousPositions.begin(), previousPositions.end(), zobrist.getHashKey()) >= 1;
+	// only positions with the same side to move since the last capture or pawn move can be equal
+	U64 key = zobrist.getHashKey();
+	int end = std::min(halfMoveClock, ply);
+	for (int i = 4; i <= end; i += 2)
+	{
+		if ((*states)[ply - i].zobristKey == key)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// count how often the current position has occured before
+int Board::countRepetitions()
+{
+	int count = 0;
+	U64 key = zobrist.getHashKey();
+	int end = std::min(halfMoveClock, ply);
+	for (int i = 4; i <= end; i += 2)
+	{
+		if ((*states)[ply - i].zobristKey == key)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+// check if a position inside the search tree can be repeated with one reversible move (cuckoo hashing)
+bool Board::hasUpcomingRepetition(int plyFromRoot)
+{
+	U64 key = zobrist.getHashKey();
+	int end = std::min({ halfMoveClock, ply, plyFromRoot - 1 });
+	for (int i = 1; i <= end; i++)
+	{
+		// repetitions over a null move aren't real
+		if (Move::isNull((*states)[ply - i].move))
+		{
+			return false;
+		}
+
+		// a single move can only lead to positions with the other side to move, at least three plies ago
+		int from, to;
+		if (i >= 3 && i % 2 == 1 && Zobrist::findReversibleMove(key ^ (*states)[ply - i].zobristKey, from, to) && !(BB::between(from, to) & takenBB))
+		{
+			return true;
+		}
+	}
+
+	return false;
 }
 
 int Board::getTurnColor()
@@ -864,11 +1236,140 @@ int Board::getTurnColor()
 	return turnColor;
 }
 
+// get pieces which are the only blocker between a square and an aligned slider
+U64 Board::sliderBlockers(int square, U64 sliders)
+{
+	U64 blockers = U64(0);
+
+	// sliders which would attack the square on an empty board
+	U64 aligned = (Magic::rookAttacks(square, U64(0)) & (sliders & (piecesBB[WHITE + ROOK] | piecesBB[BLACK + ROOK] | piecesBB[WHITE + QUEEN] | piecesBB[BLACK + QUEEN])))
+		| (Magic::bishopAttacks(square, U64(0)) & (sliders & (piecesBB[WHITE + BISHOP] | piecesBB[BLACK + BISHOP] | piecesBB[WHITE + QUEEN] | piecesBB[BLACK + QUEEN])));
+	for (; aligned != 0; aligned &= aligned - 1)
+	{
+		U64 between = BB::between(square, BB::bitScanForward(aligned)) & takenBB;
+		if (between != 0 && (between & (between - 1)) == 0)
+		{
+			blockers |= between;
+		}
+	}
+
+	return blockers;
+}
+
+// calculate the check info once and return it until a move is made
+const CheckInfo& Board::getCheckInfo()
+{
+	if (checkInfoValid)
+	{
+		return checkInfo;
+	}
+
+	int color = turnColor;
+	int kingSquare = BB::bitScanForward(piecesBB[KING + color]);
+	int enemyKingSquare = BB::bitScanForward(piecesBB[KING + !color]);
+
+	checkInfo.checkers = attackersTo(kingSquare, takenBB) & colorBB[!color];
+	checkInfo.pinned = sliderBlockers(kingSquare, colorBB[!color]) & colorBB[color];
+	checkInfo.discoveredCandidates = sliderBlockers(enemyKingSquare, colorBB[color]) & colorBB[color];
+	checkInfo.enemyKingSquare = enemyKingSquare;
+
+	// a piece gives check from the squares it would attack when standing on the enemy king's square
+	U64 rookChecks = Magic::rookAttacks(enemyKingSquare, takenBB);
+	U64 bishopChecks = Magic::bishopAttacks(enemyKingSquare, takenBB);
+	checkInfo.checkSquares = {};
+	checkInfo.checkSquares[PAWN + color] = BB::pawnAnyAttacks(piecesBB[KING + !color], !color);
+	checkInfo.checkSquares[KNIGHT + color] = BB::knightAttacksFrom(enemyKingSquare);
+	checkInfo.checkSquares[BISHOP + color] = bishopChecks;
+	checkInfo.checkSquares[ROOK + color] = rookChecks;
+	checkInfo.checkSquares[QUEEN + color] = rookChecks | bishopChecks;
+
+	checkInfoValid = true;
+	return checkInfo;
+}
+
+// check if a legal move gives check by looking at direct, discovered and special move checks
+bool Board::givesCheck(Move move)
+{
+	const CheckInfo& info = getCheckInfo();
+
+	int from = move.getFrom();
+	int to = move.getTo();
+	int color = turnColor;
+	U64 fromBB = U64(1) << from;
+	U64 toBB = U64(1) << to;
+	U64 enemyKingBB = piecesBB[KING + !color];
+
+	// direct check by the moved piece (promoted pawns are handled below)
+	if (!move.isPromotion() && (info.checkSquares[piecesMB[from]] & toBB))
+	{
+		return true;
+	}
+
+	// discovered check if the piece leaves the line between a slider and the enemy king
+	if ((info.discoveredCandidates & fromBB) && !(BB::line(from, info.enemyKingSquare) & toBB))
+	{
+		return true;
+	}
+
+	U64 ownRooks = piecesBB[ROOK + color] | piecesBB[QUEEN + color];
+	U64 ownBishops = piecesBB[BISHOP + color] | piecesBB[QUEEN + color];
+
+	switch (move.getFlag())
+	{
+	case PROMOTION_MOVE:
+	{
+		// the promoted piece attacks with the pawn already removed from its square
+		U64 occupied = takenBB ^ fromBB;
+		switch (move.getPromotionType())
+		{
+		case QUEEN:
+			return (Magic::queenAttacks(to, occupied) & enemyKingBB) != 0;
+		case ROOK:
+			return (Magic::rookAttacks(to, occupied) & enemyKingBB) != 0;
+		case BISHOP:
+			return (Magic::bishopAttacks(to, occupied) & enemyKingBB) != 0;
+		default:
+			return (BB::knightAttacksFrom(to) & enemyKingBB) != 0;
+		}
+	}
+	case EN_PASSANT_MOVE:
+	{
+		// the captured pawn can uncover a slider as well
+		U64 capturedBB = U64(1) << (to + (color == WHITE ? SOUTH : NORTH));
+		U64 occupied = (takenBB ^ fromBB ^ capturedBB) | toBB;
+		return ((Magic::rookAttacks(info.enemyKingSquare, occupied) & ownRooks) | (Magic::bishopAttacks(info.enemyKingSquare, occupied) & ownBishops)) != 0;
+	}
+	case CASTLING_MOVE:
+	{
+		// only the rook can give check after castling
+		int rookFrom = from + (to > from ? 3 : -4);
+		int rookTo = (from + to) / 2;
+		U64 occupied = (takenBB ^ fromBB ^ (U64(1) << rookFrom)) | toBB | (U64(1) << rookTo);
+		return (Magic::rookAttacks(rookTo, occupied) & enemyKingBB) != 0;
+	}
+	default:
+		return false;
+	}
+}
+
+// return if the turn color was in check during the last move generation
 bool Board::getCheck()
 {
 	return isCheck;
 }
 
+// check if a square is attacked by pieces of a color in the current position
+bool Board::isSquareAttacked(int square, int byColor)
+{
+	return (attackersTo(square, takenBB) & colorBB[byColor]) != 0;
+}
+
+// check if the king of the turn color is attacked without generating moves
+bool Board::inCheck()
+{
+	return isSquareAttacked(BB::bitScanForward(piecesBB[KING + turnColor]), !turnColor);
+}
+
 int Board::getHalfMoveClock()
 {
 	return halfMoveClock;
@@ -879,35 +1380,58 @@ int Board::getMoveCount()
 	return moveCount;
 }
 
-std::array<U64, 12> Board::getPiecesBB()
+const std::array<U64, 12>& Board::getPiecesBB()
 {
 	return piecesBB;
 }
 
-std::array<int, 64> Board::getPiecesMB()
+const std::array<int8_t, 64>& Board::getPiecesMB()
 {
 	return piecesMB;
 }
-U64 Board::getZobristKey()
+// look up the material table, only compute the information if the piece counts aren't covered by it
+MaterialEntry Board::getMaterialEntry()
 {
-	return zobrist.getHashKey();
-}
+	if (materialOverflow == 0)
+	{
+		return Material::probe(materialKey);
+	}
 
-std::array<PieceList, 12> Board::getPieceLists()
-{
-	return pieceLists;
+	std::array<int, 12> counts;
+	for (int i = 0; i < 12; i++)
+	{
+		counts[i] = BB::popCount(piecesBB[i]);
+	}
+
+	return Material::compute(counts);
 }
 
-std::vector<Move> Board::getMoveList()
+U64 Board::getZobristKey()
 {
-	return moveList;
+	return zobrist.getHashKey();
 }
 
 std::vector<Move> Board::getMoveHistory()
 {
+	std::vector<Move> moveHistory;
+	for (int i = 0; i < ply; i++)
+	{
+		moveHistory.push_back((*states)[i].move);
+	}
+
 	return moveHistory;
 }
 
+StateInfo& Board::getStateInfo()
+{
+	if (statesOwner != this)
+	{
+		throw std::logic_error("Board has no state stack of its own");
+	}
+
+	return (*states)[ply];
+}
+
 bool Board::getNormalStart()
 {
 	return normalStart;
@@ -6,12 +6,14 @@
 #include <string>
 #include <vector>
 #include <stack>
+#include <stdexcept>
 #include <chrono>
 #include <algorithm>
 
 #include "Bitboard.h"
-#include "PieceList.h"
+#include "Magic.h"
 #include "Zobrist.h"
+#include "Material.h"
 #include "Move.h"
 
 // enum for different game states
@@ -23,25 +25,55 @@ enum State
 	DRAW
 };
 
-// structure to store positional info which isn't stored in moves (to avoid added complexity in move creation)
-struct PositionalInfo
+// types of move generation, evasions are only generated when in check
+enum GenType
 {
+	ALL_MOVES,
+	CAPTURES,
+	QUIETS,
+	EVASIONS,
+	QUIET_CHECKS
+};
+
+// structure to store all information which can't be restored from a move, one entry for every ply played
+struct StateInfo
+{
+	// board information before the move
 	std::array<bool, 4> castlingRights;
 	int enPassantSquare;
 	int halfMoveClock;
+	U64 zobristKey;
+
+	// move played and piece captured by it
+	Move move;
+	int capturedPiece;
+
+	// incremental eval terms before the move (saved by the evaluation)
+	std::array<int, 2> material;
+	int whitePieceSquareEval;
+	double endgameWeight;
+};
+
+// information about checks in a position, computed once per node when it's needed
+struct CheckInfo
+{
+	U64 checkers; // enemy pieces giving check to the turn color's king
+	U64 pinned; // pieces of the turn color pinned to their own king
+	U64 discoveredCandidates; // pieces of the turn color which give a discovered check when moving off the line to the enemy king
+	std::array<U64, 12> checkSquares; // squares from which each piece type of the turn color would attack the enemy king
+	int enemyKingSquare;
 };
 
 // class for the chess board
 class Board
 {
-	const std::string startPosition = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+	static constexpr const char* startPosition = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
-	// board information (bitboards, 8x8 mailbox, piece lists)
+	// board information (bitboards and 8x8 mailbox), pieces are iterated by bitscans
 	std::array<U64, 12> piecesBB = {};
 	U64 takenBB = U64(0);
 	std::array<U64, 2> colorBB = {};
-	std::array<int, 64> piecesMB = {};
-	std::array<PieceList, 12> pieceLists = {};
+	std::array<int8_t, 64> piecesMB = {};
 
 	// chess board properties
 	bool turnColor = WHITE;
@@ -50,27 +82,24 @@ class Board
 	int halfMoveClock = 0;
 	int moveCount = 1;
 	Zobrist zobrist;
+
+	// material key of the piece counts and number of piece types with more pieces than the material table covers
+	int materialKey = 0;
+	int materialOverflow = 0;
 	bool isCheck = false;
 	bool normalStart = true;
 
-	// stack for reversing previous moves, list of all zobrist keys of previous positions, move history
-	std::stack<PositionalInfo> previousInfo;
-	std::vector<U64> previousPositions;
-	std::vector<Move> moveHistory;
-
-	// list of all possible moves in current position
-	std::vector<Move> moveList;
-
-	// direction array and direction to index map
-	std::array<int, 16> dirs = { EAST,             WEST,             NORTH,            SOUTH,
-			    				 NORTH_EAST,       SOUTH_WEST,       SOUTH_EAST,       NORTH_WEST,
-			    				 NORTH_NORTH_EAST, SOUTH_SOUTH_EAST, NORTH_NORTH_WEST, SOUTH_SOUTH_WEST,
-								 NORTH_EAST_EAST,  NORTH_WEST_WEST,  SOUTH_EAST_EAST,  SOUTH_WEST_WEST };
-	 
-	std::map<int, int> dirToIndex = { {EAST, 0},             {WEST, 1},             {NORTH, 2},             {SOUTH, 3},
-									  {NORTH_EAST, 4},       {SOUTH_WEST, 5},       {SOUTH_EAST, 6},        {NORTH_WEST, 7},
-									  {NORTH_NORTH_EAST, 8}, {SOUTH_SOUTH_EAST, 9}, {NORTH_NORTH_WEST, 10}, {SOUTH_SOUTH_WEST, 11},
-									  {NORTH_EAST_EAST, 12}, {NORTH_WEST_WEST, 13}, {SOUTH_EAST_EAST, 14},  {SOUTH_WEST_WEST, 15} };
+	// check info of the current position, invalidated by every move
+	CheckInfo checkInfo;
+	bool checkInfoValid = false;
+
+	// state stack for reversing previous moves, indexed by the ply since the position was loaded
+	// the stack is owned by the user of the board (engine, search or perft thread), so a copy of the board is only the position
+	std::vector<StateInfo>* states = nullptr;
+	int ply = 0;
+
+	// board which set the stack, a copy still points to the stack of the original and mustn't write to it
+	const Board* statesOwner = nullptr;
 
 	// helper functions for makeMove
 	void movePiece(int piece, int from, int to);
@@ -78,23 +107,52 @@ class Board
 	void removePiece(int piece, int square);
 	void rookChanged(int square);
 
+	// pieces of both colors which are the only blocker between a square and a slider of the given set
+	U64 sliderBlockers(int square, U64 sliders);
+
+	// move generation for one color and generation type
+	template <int Color, int Type>
+	void generateMoves(MoveList& moveList);
+
 public:
 	// load and get board position from FEN
 	void loadStartPosition();
 	void loadFromFen(std::string fen);
 	std::string getFen();
 
-	// make and unmake a given move
+	// use a state stack for the following moves, the states of the plies played so far are copied into it
+	void setStateStack(std::vector<StateInfo>& stack);
+
+	// make and unmake a given move, a state stack has to be set
 	void makeMove(Move move);
 	void unmakeMove(Move move);
 
-	// generate moves based on position
-	void generateMoves(bool onlyCaputures = false);
+	// generate moves based on position into the given list
+	void generateMoves(MoveList& moveList, int genType = ALL_MOVES);
+
+	// check if a move (e. g. from the transposition table or a killer) is pseudo-legal or legal without generating moves
+	bool isPseudoLegal(Move move);
+	bool isLegal(Move move);
 
-	// get the state of the game
+	// attack queries without generating moves, attackers are pieces of both colors
+	U64 attackersTo(int square, U64 occupied);
+	bool isSquareAttacked(int square, int byColor);
+	bool inCheck();
+
+	// check info of the current position and whether a legal move gives check, without making it
+	const CheckInfo& getCheckInfo();
+	bool givesCheck(Move move);
+
+	// get pieces involved in a move before it's made
+	int getMovedPiece(Move move);
+	int getCapturedPiece(Move move);
+
+	// get the state of the game, move list has to be generated in the current position
 	bool checkDraw();
-	int getState();
+	int getState(MoveList& moveList);
 	bool checkRepetition();
+	int countRepetitions();
+	bool hasUpcomingRepetition(int plyFromRoot);
 
 	// return board properties
 	int getTurnColor();
@@ -104,14 +162,16 @@ public:
 	bool getNormalStart();
 
 	// return piece information
-	std::array<U64, 12> getPiecesBB();
-	std::array<int, 64> getPiecesMB();
-	std::array<PieceList, 12> getPieceLists();
+	const std::array<U64, 12>& getPiecesBB();
+	const std::array<int8_t, 64>& getPiecesMB();
 
 	// return zobrist key
 	U64 getZobristKey();
 
-	// return legal moves and move history
-	std::vector<Move> getMoveList();
+	// return material information of the current piece counts
+	MaterialEntry getMaterialEntry();
+
+	// return move history and state info of the current ply
 	std::vector<Move> getMoveHistory();
+	StateInfo& getStateInfo();
 };
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "Cpu.h"
+
+bool Cpu::popcnt = false;
+bool Cpu::pext = false;
+bool Cpu::avx2 = false;
+
+// detect the CPU features with CPUID
+bool Cpu::init()
+{
+#if defined(CPU_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	popcnt = __builtin_cpu_supports("popcnt");
+	avx2 = __builtin_cpu_supports("avx2");
+
+	// PEXT is microcoded and slower than magic multiplication on AMD before Zen 3
+	bool slowPext = __builtin_cpu_is("amdfam15h") || __builtin_cpu_is("amdfam17h");
+	pext = __builtin_cpu_supports("bmi2") && !slowPext;
+#elif defined(CPU_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+	bool amd = info[1] == 0x68747541; // "Auth" of "AuthenticAMD"
+
+	__cpuid(info, 1);
+	int family = ((info[0] >> 8) & 0xF) + (((info[0] >> 8) & 0xF) == 0xF ? (info[0] >> 20) & 0xFF : 0);
+	popcnt = (info[2] >> 23) & 1;
+
+	// AVX2 also needs the operating system to save the YMM registers
+	bool osSavesYmm = ((info[2] >> 27) & 1) && (_xgetbv(0) & 0x6) == 0x6;
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = ((info[1] >> 5) & 1) && osSavesYmm;
+		pext = ((info[1] >> 8) & 1) && !(amd && family >= 0x15 && family <= 0x18);
+	}
+#endif
+
+	return true;
+}
+
+// name of the used features, e.g. "popcnt pext avx2"
+std::string Cpu::getName()
+{
+	std::string name = "";
+	if (popcnt)
+	{
+		name += " popcnt";
+	}
+	if (pext)
+	{
+		name += " pext";
+	}
+	if (avx2)
+	{
+		name += " avx2";
+	}
+
+	return name.empty() ? "generic" : name.substr(1);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include <bit>
+#include <string>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CPU_X86
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// functions using instructions outside of the base instruction set are compiled for that set only (MSVC allows intrinsics anyway)
+#if defined(CPU_X86) && defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+// class for detecting CPU features once at startup, hot kernels pick their instruction set variant with these flags
+class Cpu
+{
+public:
+	// features used by the kernels (PEXT only if BMI2 is supported and PEXT isn't microcoded)
+	static bool popcnt;
+	static bool pext;
+	static bool avx2;
+
+	// detect the features, called once before the tables are initialized
+	static bool init();
+
+	// name of the used features for the uci id string
+	static std::string getName();
+
+	// popcnt and pext instructions, only to be executed if the CPU supports them
+	static int popcntInstruction(uint64_t x)
+	{
+#if defined(CPU_X86) && defined(__GNUC__)
+		uint64_t count;
+		asm("popcntq %1, %0" : "=r"(count) : "r"(x));
+		return (int)count;
+#elif defined(CPU_X86) && defined(_MSC_VER)
+		return (int)__popcnt64(x);
+#else
+		return std::popcount(x);
+#endif
+	}
+
+	static uint64_t pextInstruction(uint64_t x, uint64_t mask)
+	{
+#if defined(CPU_X86) && defined(__GNUC__)
+		uint64_t result;
+		asm("pextq %2, %1, %0" : "=r"(result) : "r"(x), "r"(mask));
+		return result;
+#elif defined(CPU_X86) && defined(_MSC_VER)
+		return _pext_u64(x, mask);
+#else
+		return 0;
+#endif
+	}
+};
\ No newline at end of file
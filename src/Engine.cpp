@@ -1,11 +1,19 @@
 #include "Engine.h"
 
 // initialize transposition table, openings and evaluation
-Engine::Engine() : openings(Openings::loadOpenings()), tt(TranspositionTable(board)), evaluation(board, tt)
+Engine::Engine() : openings(Openings::loadOpenings()), evaluation(board, tt)
 {
+	board.setStateStack(states);
 	loadStartPosition();
 }
 
+// end a running search before the searchers are destroyed
+Engine::~Engine()
+{
+	stopSearch();
+	waitForSearch();
+}
+
 // actions upon loading new board position
 void Engine::loadStartPosition()
 {
@@ -22,14 +30,14 @@ void Engine::loadFromFen(std::string fen)
 // actions when new move is played/unplayed
 void Engine::makeMove(Move move)
 {
-	board.makeMove(move);
 	evaluation.makeMove(move);
+	board.makeMove(move);
 }
 
 void Engine::unmakeMove(Move move)
 {
 	board.unmakeMove(move);
-	evaluation.unmakeMove(move);
+	evaluation.unmakeMove();
 }
 
 // actions when a new game starts
@@ -38,41 +46,78 @@ void Engine::newGame()
 	tt.clear();
 }
 
-// return principal variation as string
-std::string Engine::getPrincipalVariation(int depth)
+// print out info about the deepest completed search of a searcher, nodes are counted over all threads
+void Engine::printInfo(Searcher& searcher)
 {
-	// iterate through moves in the transposition table while saving moves made
-	std::optional<Move> move = tt.getStoredMove(board, true);
-	std::stack<Move> moveStack;
-	std::string pvString = "";
+	long long nodes = 0;
+	for (std::unique_ptr<Searcher>& threadSearcher : searchers)
+	{
+		nodes += threadSearcher->getNodes();
+	}
 
-	for (int i = 0; i < depth && move.has_value() && board.getState() == PLAY; i++)
+	// the line is written at once so it doesn't interleave with output of the uci thread
+	std::chrono::duration<double> diff = std::chrono::system_clock::now() - control.start;
+	std::ostringstream info;
+	info << "info score " << Score::toString(searcher.getCompletedEval()) << " depth " << searcher.getCompletedDepth() << " nodes " << nodes << " time " << (int)(diff.count() * 1000) << " nps " << (int)(nodes / diff.count()) << " pv";
+	for (Move move : searcher.getCompletedPv())
 	{
-		pvString += " " + (*move).getNotation();
-		moveStack.push(*move);
-		makeMove(*move);
-		move = tt.getStoredMove(board, true);
+		info << " " << move.getNotation();
 	}
+	info << "\n";
+	std::cout << info.str() << std::flush;
+}
+
+// start a search on the search thread, the flags are set here so a stop or ponderhit sent right after go isn't lost
+void Engine::startSearch(int timeLeft, int increment, int depth, int exactTime, bool infinite, bool ponder)
+{
+	waitForSearch();
+	control.stop = false;
+	control.pondering = ponder;
 
-	// undo changes
-	while (!moveStack.empty())
+	searchThread = std::thread([this, timeLeft, increment, depth, exactTime, infinite]()
 	{
-		unmakeMove(moveStack.top());
-		moveStack.pop();
+		Move move = getBestMove(timeLeft, increment, depth, exactTime, infinite);
+
+		// the expected reply is pondered on during the opponent's turn
+		std::cout << "bestmove " + move.getNotation() + (Move::isNull(ponderMove) ? "" : " ponder " + ponderMove.getNotation()) + "\n" << std::flush;
+	});
+}
+
+// stop the current search, the best move is printed by the search thread
+void Engine::stopSearch()
+{
+	control.stop = true;
+}
+
+// the opponent played the pondered move, the search goes on under the time limit which started with the ponder search
+void Engine::ponderHit()
+{
+	control.pondering = false;
+}
+
+// wait until the search may return, infinite searches need a stop and ponder searches a stop or ponderhit
+void Engine::waitForStop(bool infinite)
+{
+	while ((infinite || control.pondering) && !control.stop)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
 	}
-	
-	// cut first space if present
-	if (pvString != "")
+}
+
+// wait until the current search has printed its best move
+void Engine::waitForSearch()
+{
+	if (searchThread.joinable())
 	{
-		return pvString.substr(1);
+		searchThread.join();
 	}
-	
-	return "";
 }
 
 // calculate best move in current position
-Move Engine::getBestMove(int timeLeft, int increment, int depthLimit, int exactTime)
+Move Engine::getBestMove(int timeLeft, int increment, int depthLimit, int exactTime, bool infinite)
 {
+	ponderMove = Move::nullmove();
+
 	if (useOpeningBook && board.getNormalStart())
 	{
 		// if the current position is in an opening, play a random follow-up move
@@ -80,250 +125,103 @@ Move Engine::getBestMove(int timeLeft, int increment, int depthLimit, int exactT
 
 		if (gameNode.has_value())
 		{
-			bestMove = Move::loadFromNotation(gameNode->randomMove(), board.getPiecesMB());
+			bestMove = Move::loadFromNotation(gameNode->randomMove(), board);
+			waitForStop(infinite);
 			return bestMove;
 		}
 	}
 
-	if (depthLimit != -1)
+	if (depthLimit != -1 || infinite)
 	{
-		timeLimit = 1000000;
+		control.timeLimit = 1000000;
 	}
 	else if (timeLeft != -1)
 	{
 		// calculate the expected time per move
-		timeLimit = (timeLeft / 40.0 + increment) / 1000 - moveOverhead;
+		control.timeLimit = (timeLeft / 40.0 + increment) / 1000 - moveOverhead;
 	}
 	else if (exactTime != -1)
 	{
-		timeLimit = exactTime / 1000.0;
+		control.timeLimit = exactTime / 1000.0;
 	}
 	else
 	{
 		// if no time control - use default value
-		timeLimit = defaultTimeLimit;
+		control.timeLimit = defaultTimeLimit;
 	}
 
-	bestMove = Move::nullmove();
-	bestEval = LOWEST_SCORE;
-	searchStart = std::chrono::system_clock::now();
-	searchAborted = false;
-
-	nodes = 0;
-	int depth;
-
-	// go through all depths until time or depth limit is reached
-	for (depth = 1; !searchAborted; depth++)
-	{
-		search(LOWEST_SCORE, HIGHEST_SCORE, depth, 0, false);
-
-		// print out info about current search
-		if (!searchAborted)
-		{
-			std::chrono::duration<double> diff = std::chrono::system_clock::now() - searchStart;
-			std::cout << std::fixed;
-			std::cout << "info score " << Score::toString(bestEval) << " depth " << depth << " nodes " << nodes << " time " << (int)(diff.count() * 1000) << " nps " << (int)(nodes / diff.count()) << " pv " << getPrincipalVariation(depth) << "\n";
-		}
-
-		if (depth == depthLimit)
-		{
-			searchAborted = true;
-		}
-	}
-
-	// decrease depth counter to cancel out the depth++ at the end of the loop
-	depth--;
-
-	// if search hasn't even crossed depth 1 or is illegal (because of bugs or zobrist key collisions), get the best looking move
-	board.generateMoves();
-	std::vector<Move> moves = board.getMoveList();
-	if (Move::isNull(bestMove) || std::find(moves.begin(), moves.end(), bestMove) == moves.end())
-	{
-		std::cout << "Search error! Move found: " << bestMove.getNotation() << ". Move is chosen by move ordering.\n";
-		std::vector<Move> moves = board.getMoveList();
-		evaluation.orderMoves(moves);
-		bestMove = moves[0];
-	}
-
-	auto end = std::chrono::system_clock::now();
-	std::chrono::duration<double> diff = end - searchStart;
-
-	// print out search stats
-	std::cout << std::fixed;
-	std::cout << "info score " << Score::toString(bestEval) << " depth " << depth << " nodes " << nodes << " time " << (int)(diff.count() * 1000) << " nps " << (int)(nodes / diff.count()) << " pv " << getPrincipalVariation(depth) << "\n";
-
-	return bestMove;
-}
-
-// minimax search of the game tree
-int Engine::search(int alpha, int beta, int depth, int plyFromRoot, bool nullMove)
-{
-	// if the time limit has been reached, abort search and return
-	std::chrono::duration<double> diff = std::chrono::system_clock::now() - searchStart;
-	if (diff.count() >= timeLimit)
-	{
-		searchAborted = true;
-		return alpha;
-	}
+	control.start = std::chrono::system_clock::now();
 
-	nodes++;
-	 
-	// mark a two-fold repetition as a draw (not completely correct)
-	if (board.checkRepetition() && plyFromRoot > 1)
+	// every thread gets its own searcher, they only share the transposition table
+	searchers.clear();
+	for (int i = 0; i < threads; i++)
 	{
-		return DRAW_SCORE;
+		searchers.push_back(std::make_unique<Searcher>(board, tt, control, i == 0));
 	}
 
-	// check for trivial draws before generating moves
-	if (board.checkDraw())
-	{
-		return DRAW_SCORE;
-	}
+	// no thread searches deeper than the depth limit
+	int lastDepth = (depthLimit > 0) ? std::min(depthLimit, Searcher::maxDepth) : Searcher::maxDepth;
 
-	// get the stored eval in the transposition table
-	std::optional<int> ttEval = tt.getStoredEval(depth, plyFromRoot, alpha, beta);
-	if (ttEval.has_value())
+	// helper threads start at alternating depths so they don't all search the same tree
+	std::vector<std::thread> helpers;
+	for (int i = 1; i < threads; i++)
 	{
-		// replace best move if it's the main search function
-		if (plyFromRoot == 0)
-		{
-			bestMove = *tt.getStoredMove(board, true);
-			bestEval = *ttEval;
-		}
-
-		return *ttEval;
+		helpers.emplace_back(&Searcher::iterate, searchers[i].get(), std::min(1 + i % 2, lastDepth), lastDepth);
 	}
 
-	// evaluate board with quiescence search if depth limit Sis reached
-	if (depth == 0)
+	// the main thread goes through all depths until time or depth limit is reached
+	Searcher& mainSearcher = *searchers[0];
+	for (int depth = 1; depth <= lastDepth && mainSearcher.searchDepth(depth); depth++)
 	{
-		return quiescenceSearch(alpha, beta);
+		// print out info about current search
+		printInfo(mainSearcher);
 	}
 
-	board.generateMoves();
-	std::vector<Move> moves = board.getMoveList();
-	evaluation.orderMoves(moves);
+	// the best move isn't returned before a stop or ponderhit
+	waitForStop(infinite);
 
-	// check if game ended, return scores based on state
-	int state = board.getState();
-
-	if ((state == WHITE_WIN) || (state == BLACK_WIN))
-	{
-		return Score::getNegativeMate(plyFromRoot);
-	}
-	else if (state == DRAW)
+	// stop the helper threads
+	control.stop = true;
+	for (std::thread& helper : helpers)
 	{
-		return DRAW_SCORE;
+		helper.join();
 	}
 
-	// evaluate null move for null move pruning
-	if (!board.getCheck() && !nullMove && depth > 3)
+	// take the move of the thread which completed the deepest search
+	Searcher* bestSearcher = &mainSearcher;
+	for (std::unique_ptr<Searcher>& searcher : searchers)
 	{
-		makeMove(Move::nullmove());
-		int nullEval = -search(-beta, -alpha, depth - 4, plyFromRoot + 1, true);
-		unmakeMove(Move::nullmove());
-
-		if (nullEval >= beta)
+		if (searcher->getCompletedDepth() > bestSearcher->getCompletedDepth())
 		{
-			return beta;
+			bestSearcher = searcher.get();
 		}
 	}
+	bestMove = bestSearcher->getCompletedMove();
 
-	Move bestPositionMove = Move::nullmove();
-	int nodeType = UPPER_BOUND_NODE;
-
-	// loop through all legal moves
-	for (Move& move : moves)
-	{
-		// get score of given move
-		makeMove(move);
-		int eval = -search(-beta, -alpha, depth - 1, plyFromRoot + 1, nullMove);
-		unmakeMove(move);
-
-		// beta-cutoff (move is too good to be allowed by the opponent)
-		if (eval >= beta)
-		{
-			tt.storeEntry(beta, depth, move, LOWER_BOUND_NODE, plyFromRoot);
-			return beta;
-		}
-
-		// new best move for the position is found
-		if (eval > alpha)
-		{
-			alpha = eval;
-			bestPositionMove = move;
-			nodeType = EXACT_NODE;
-			
-			// save move as best move if it's the main search function
-			if (plyFromRoot == 0)
-			{
-				bestMove = move;
-				bestEval = eval;
-			}
-		}
-	}
-
-	tt.storeEntry(alpha, depth, bestPositionMove, nodeType, plyFromRoot);
-	return alpha;
-}
-
-// evaluate all non-quiet/messy positions
-int Engine::quiescenceSearch(int alpha, int beta)
-{
-	// if the time limit has been reached, abort search and return
-	std::chrono::duration<double> diff = std::chrono::system_clock::now() - searchStart;
-	if (diff.count() >= timeLimit)
-	{
-		searchAborted = true;
-		return alpha;
-	}
-
-	nodes++;
+	// the expected reply is the second move of the principal variation of that search
+	const std::vector<Move>& pv = bestSearcher->getCompletedPv();
+	ponderMove = (pv.size() >= 2 && pv[0] == bestMove) ? pv[1] : Move::nullmove();
 
-	// check for trivial draws
-	if (board.checkDraw())
+	// if search hasn't even completed depth 1, take the best move found so far or the best looking move
+	if (Move::isNull(bestMove))
 	{
-		return DRAW_SCORE;
+		bestMove = mainSearcher.getBestMove();
 	}
-
-	int eval = evaluation.evaluate();
-
-	// static eval is used as a lower-bound of the score, assuming there is a better move than doing nothing (null move observation)
-	if (eval >= beta)
+	if (Move::isNull(bestMove))
 	{
-		return beta;
-	}
-	if (eval > alpha)
-	{
-		alpha = eval;
+		MoveList moves;
+		board.generateMoves(moves);
+		evaluation.orderMoves(moves);
+		bestMove = moves[0];
 	}
 
-	board.generateMoves(true);
-	std::vector<Move> moves = board.getMoveList();
-	evaluation.orderMoves(moves);
-
-	// loop through all legal captures
-	for (const Move& move : moves)
+	// the main thread has printed its completed depths already, a deeper helper thread is printed out here
+	if (bestSearcher != &mainSearcher)
 	{
-		// get score of given move
-		makeMove(move);
-		int eval = -quiescenceSearch(-beta, -alpha);
-		unmakeMove(move);
-
-		// beta-cutoff (move is too good to be allowed by the opponent)
-		if (eval >= beta)
-		{
-			return beta;
-		}
-
-		// new best move for the position is found
-		if (eval > alpha)
-		{
-			alpha = eval;
-		}
+		printInfo(*bestSearcher);
 	}
 
-	return alpha;
+	return bestMove;
 }
 
 // evaluate current position
@@ -344,6 +242,23 @@ void Engine::setHash(int sizeMB)
 	tt.setSizeMB(sizeMB);
 }
 
+// option how many threads should search
+void Engine::setThreads(int threadCount)
+{
+	threads = std::max(1, threadCount);
+}
+
+// options for tuning the late move reductions, in hundredths
+void Engine::setReductionBase(int base)
+{
+	Searcher::setReductionBase(base);
+}
+
+void Engine::setReductionDivisor(int divisor)
+{
+	Searcher::setReductionDivisor(divisor);
+}
+
 // option how long the move overhead should be in ms
 void Engine::setMoveOverhead(int moveOverheadMs)
 {
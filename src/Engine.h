@@ -1,8 +1,13 @@
 #pragma once
+#include <memory>
+#include <sstream>
+#include <thread>
 #include "Board.h"
 #include "TranspositionTable.h"
 #include "Openings.h"
 #include "Evaluation.h"
+#include "MovePicker.h"
+#include "Searcher.h"
 
 // class for a chess engine
 class Engine
@@ -10,32 +15,38 @@ class Engine
 	// UCI options
 	bool useOpeningBook = true;
 	double moveOverhead = 0.01;
+	int threads = 1;
 
 	Board board;
+	std::vector<StateInfo> states;
 
-	std::chrono::time_point<std::chrono::system_clock> searchStart;
-	bool searchAborted = false;
+	// search threads of the current search, the first one is the main thread
+	SearchControl control;
+	std::vector<std::unique_ptr<Searcher>> searchers;
 
-	double timeLimit = 0;
 	const double defaultTimeLimit = 7;
 
 	Move bestMove = Move::nullmove();
-	int bestEval = LOWEST_SCORE;
-
-	long long nodes = 0;
+	Move ponderMove = Move::nullmove();
 
 	TranspositionTable tt;
 	Openings openings;
 
 	Evaluation evaluation;
 
-	int search(int alpha, int beta, int depth, int plyFromRoot, bool nullMove);
-	int quiescenceSearch(int alpha, int beta);
-	std::string getPrincipalVariation(int depth);
+	// thread running the current search, the uci thread stays free for stop and isready
+	std::thread searchThread;
+
+	// print out info about the deepest completed search of a searcher
+	void printInfo(Searcher& searcher);
+
+	Move getBestMove(int timeLeft, int increment, int depthLimit, int exactTime, bool infinite);
+	void waitForStop(bool infinite);
 
 public:
 	
 	Engine();
+	~Engine();
 
 	// actions upon loading board position
 	void loadStartPosition();
@@ -46,13 +57,22 @@ public:
 	void unmakeMove(Move move);
 
 	void newGame();
-	Move getBestMove(int timeLeft = -1, int increment = 0, int depth = -1, int exactTime = -1);
+
+	// search on the search thread and print out the best move, infinite searches only end on stop and ponder searches on stop or ponderhit
+	void startSearch(int timeLeft = -1, int increment = 0, int depth = -1, int exactTime = -1, bool infinite = false, bool ponder = false);
+	void stopSearch();
+	void ponderHit();
+	void waitForSearch();
+
 	int evaluate();
 
 	// change UCI options
 	void setOwnBook(bool useOwnBook);
 	void setHash(int sizeMB);
 	void setMoveOverhead(int moveOverheadMs);
+	void setThreads(int threadCount);
+	void setReductionBase(int base);
+	void setReductionDivisor(int divisor);
 
 	Board& getBoard();
 };
\ No newline at end of file
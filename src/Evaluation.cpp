@@ -1,49 +1,48 @@
 #include "Evaluation.h"
 
-Evaluation::Evaluation(Board& boardPar, TranspositionTable& ttPar) : board(boardPar), tt(ttPar)
+// map for converting piece ids to value
+constexpr std::array<int, 14> Evaluation::pieceValues = {
+	0, 0,       // empty
+	1000, 1000, // king 
+	850, 850,   // queen
+	310, 310,   // bishop
+	312, 312,   // knight
+	496, 496,   // rook
+	79, 79      // pawn
+};
+
+// bitboards for pawn shields for each color and wing
+constexpr std::array<std::array<U64, 2>, 2> Evaluation::pawnShieldBBs = { {
+	{ 0x0007070000000000, 0x00e0e00000000000 },
+	{ 0x0000000000070700, 0x0000000000e0e000 }
+} };
+
+// bitboards for each file
+constexpr std::array<U64, 8> Evaluation::fileBBs = { 0x0101010101010101, 0x0202020202020202, 0x0404040404040404, 0x0808080808080808,
+													 0x1010101010101010, 0x2020202020202020, 0x4040404040404040, 0x8080808080808080 };
+
+// calculate near square bitboards for every square at compile time
+constexpr std::array<U64, 64> Evaluation::nearKingSquares = []()
 {
-	// map for converting piece ids to value
-	pieceValues = { 
-		0, 0,       // empty
-		1000, 1000, // king 
-		850, 850,   // queen
-		310, 310,   // bishop
-		312, 312,   // knight
-		496, 496,   // rook
-		79, 79      // pawn
-	};   
-
-	// bitboards for pawn shields for each color and wing
-	pawnShieldBBs[0][0] = 0x0007070000000000;
-	pawnShieldBBs[1][0] = 0x0000000000070700;
-	pawnShieldBBs[0][1] = 0x00e0e00000000000;
-	pawnShieldBBs[1][1] = 0x0000000000e0e000;
-
-	// bitboards for each file
-	fileBBs[0] = 0x0101010101010101;
-	fileBBs[1] = 0x0202020202020202;
-	fileBBs[2] = 0x0404040404040404;
-	fileBBs[3] = 0x0808080808080808;
-	fileBBs[4] = 0x1010101010101010;
-	fileBBs[5] = 0x2020202020202020;
-	fileBBs[6] = 0x4040404040404040;
-	fileBBs[7] = 0x8080808080808080;
-
-	// calculate near square bitboards for every square
+	std::array<U64, 64> nearSquares = {};
 	for (int i = 0; i < 64; i++)
 	{
-		U64 square = 0;
-
 		for (int j = 0; j < 64; j++)
 		{
-			if (std::abs(Square::rankOf(i) - Square::rankOf(j)) <= 3 && std::abs(Square::fileOf(i) - Square::fileOf(j)) <= 2)
+			int rankDistance = i / 8 - j / 8;
+			int fileDistance = i % 8 - j % 8;
+			if (rankDistance >= -3 && rankDistance <= 3 && fileDistance >= -2 && fileDistance <= 2)
 			{
-				square |= U64(1) << j;
+				nearSquares[i] |= U64(1) << j;
 			}
 		}
-
-		nearKingSquares[i] = square;
 	}
+
+	return nearSquares;
+}();
+
+Evaluation::Evaluation(Board& boardPar, TranspositionTable& ttPar) : board(boardPar), tt(ttPar)
+{
 }
 
 int Evaluation::getPieceValue(int piece)
@@ -54,70 +53,77 @@ int Evaluation::getPieceValue(int piece)
 // initial eval in new position
 void Evaluation::reloadEval()
 {
-	// reset history
-	materialHistory = std::stack<std::array<int, 2>>();
-	whitePieceSquareHistory = std::stack<int>();
-	endgameWeightHistory = std::stack<double>();
-
 	// calculate material and piece square eval from white's perspective
-	std::array<PieceList, 12> pieceLists = board.getPieceLists();
-	material = countMaterial(pieceLists);
+	const std::array<U64, 12>& piecesBB = board.getPiecesBB();
+	material = countMaterial(piecesBB);
 	oldEndgameWeight = getEndgameWeight(material);
-	whitePieceSquareEval = countPieceSquareEval(pieceLists, WHITE, oldEndgameWeight);
+	whitePieceSquareEval = countPieceSquareEval(piecesBB, WHITE, oldEndgameWeight);
 }
 
-// actions when new move is played, incremental eval updates
+// actions when new move is played (before it's made on the board), incremental eval updates
 void Evaluation::makeMove(Move move)
 {
-	// add old eval terms so they can be undone
-	materialHistory.push(material);
-	whitePieceSquareHistory.push(whitePieceSquareEval);
-	endgameWeightHistory.push(oldEndgameWeight);
+	// save old eval terms in the board's state stack so they can be undone
+	StateInfo& info = board.getStateInfo();
+	info.material = material;
+	info.whitePieceSquareEval = whitePieceSquareEval;
+	info.endgameWeight = oldEndgameWeight;
+
+	// null moves don't change the eval terms
+	if (Move::isNull(move))
+	{
+		return;
+	}
 
-	std::array<PieceList, 12> pieceLists = board.getPieceLists();
-	int moveColor = Piece::colorOf(move.piece);
+	const std::array<U64, 12>& piecesBB = board.getPiecesBB();
+	int from = move.getFrom();
+	int to = move.getTo();
+	int piece = board.getMovedPiece(move);
+	int cPiece = board.getCapturedPiece(move);
+	int moveColor = Piece::colorOf(piece);
+	int promotion = move.isPromotion() ? move.getPromotionType() + moveColor : EMPTY;
 
 	// remove captured material
-	if (move.cPiece != EMPTY)
+	if (cPiece != EMPTY)
 	{
-		material[!moveColor] -= getPieceValue(move.cPiece);
+		material[!moveColor] -= getPieceValue(cPiece);
 	}
 
 	// add material upon promotion
-	if (move.promotion != EMPTY)
+	if (promotion != EMPTY)
 	{
-		material[moveColor] += getPieceValue(move.promotion) - getPieceValue(PAWN);
+		material[moveColor] += getPieceValue(promotion) - getPieceValue(PAWN);
 	}
 
 	// change piece square eval of the moved piece from white's perspective
 	double newEndgameWeight = getEndgameWeight(material);
-	double pieceSquareChange = pieceSquareTables.getScore(move.piece, move.to, newEndgameWeight) - pieceSquareTables.getScore(move.piece, move.from, oldEndgameWeight);
+	double pieceSquareChange = pieceSquareTables.getScore(piece, to, newEndgameWeight) - pieceSquareTables.getScore(piece, from, oldEndgameWeight);
 	int whitePieceSquareChange = pieceSquareChange * (moveColor == WHITE ? 1 : -1);
 	whitePieceSquareEval += whitePieceSquareChange;
 
 	// remove piece square eval of captured piece
-	if (move.cPiece != EMPTY)
+	if (cPiece != EMPTY)
 	{
 		// calculate the square of enemy piece
-		int capturedSquare = move.to;
-		if (move.enPassant)
+		int capturedSquare = to;
+		if (move.isEnPassant())
 		{
 			capturedSquare += (moveColor == WHITE) ? SOUTH : NORTH;
 		}
 
-		pieceSquareChange = -pieceSquareTables.getScore(move.cPiece, capturedSquare, oldEndgameWeight);
+		pieceSquareChange = -pieceSquareTables.getScore(cPiece, capturedSquare, oldEndgameWeight);
 		whitePieceSquareChange = pieceSquareChange * (!moveColor == WHITE ? 1 : -1);
 		whitePieceSquareEval += whitePieceSquareChange;
 	}
 
 	// change piece square eval of kings if material and therefore endgame weight has changed
-	if (move.cPiece != EMPTY || move.promotion != EMPTY)
+	if (cPiece != EMPTY || promotion != EMPTY)
 	{
 		// change piece square eval of ally king
-		if (Piece::typeOf(move.piece) != KING)
+		if (Piece::typeOf(piece) != KING)
 		{
 			int kingPiece = moveColor + KING;
-			int kingSquare = pieceLists[kingPiece][0];
+			int kingSquare = BB::bitScanForward(piecesBB[kingPiece]);
 			pieceSquareChange = pieceSquareTables.getScore(kingPiece, kingSquare, newEndgameWeight) - pieceSquareTables.getScore(kingPiece, kingSquare, oldEndgameWeight);
 			whitePieceSquareChange = pieceSquareChange * (moveColor == WHITE ? 1 : -1);
 			whitePieceSquareEval += whitePieceSquareChange;
@@ -125,18 +131,18 @@ void Evaluation::makeMove(Move move)
 
 		// change piece square eval of enemy king
 		int kingPiece = !moveColor + KING;
-		int kingSquare = pieceLists[kingPiece][0];
+		int kingSquare = BB::bitScanForward(piecesBB[kingPiece]);
 		pieceSquareChange = pieceSquareTables.getScore(kingPiece, kingSquare, newEndgameWeight) - pieceSquareTables.getScore(kingPiece, kingSquare, oldEndgameWeight);
 		whitePieceSquareChange = pieceSquareChange * (!moveColor == WHITE ? 1 : -1);
 		whitePieceSquareEval += whitePieceSquareChange;
 	}
 
 	// if move is castling
-	if (move.castling)
+	if (move.isCastling())
 	{
 		// check if castling is queenside, calculate rank
-		bool queenside = Square::fileOf(move.to) == 2;
-		int rank = Square::rankOf(move.from) * 8;
+		bool queenside = Square::fileOf(to) == 2;
+		int rank = Square::rankOf(from) * 8;
 
 		// calculate from and to squares of rook
 		int rookFrom = rank + (queenside ? 0 : 7);
@@ -150,9 +156,9 @@ void Evaluation::makeMove(Move move)
 	}
 
 	// change piece square eval upon promotion
-	if (move.promotion != EMPTY)
+	if (promotion != EMPTY)
 	{
-		pieceSquareChange = pieceSquareTables.getScore(move.promotion, move.to, newEndgameWeight) - pieceSquareTables.getScore(move.piece, move.to, newEndgameWeight);
+		pieceSquareChange = pieceSquareTables.getScore(promotion, to, newEndgameWeight) - pieceSquareTables.getScore(piece, to, newEndgameWeight);
 		whitePieceSquareChange = pieceSquareChange * (moveColor == WHITE ? 1 : -1);
 		whitePieceSquareEval += whitePieceSquareChange;
 	}
@@ -162,68 +168,78 @@ void Evaluation::makeMove(Move move)
 }
 
 // actions when move is unplayed, incremental eval updates
-void Evaluation::unmakeMove(Move move)
+void Evaluation::unmakeMove()
 {
-	// load values from history
-	material = materialHistory.top();
-	whitePieceSquareEval = whitePieceSquareHistory.top();
-	oldEndgameWeight = endgameWeightHistory.top();
-
-	// remove values from history
-	materialHistory.pop();
-	whitePieceSquareHistory.pop();
-	endgameWeightHistory.pop();
+	// load values from the board's state stack (the board has already been unmade)
+	StateInfo& info = board.getStateInfo();
+	material = info.material;
+	whitePieceSquareEval = info.whitePieceSquareEval;
+	oldEndgameWeight = info.endgameWeight;
 }
 
-// order list of moves from best to worst
-void Evaluation::orderMoves(std::vector<Move>& moves)
+// score moves by how promising they look
+void Evaluation::scoreMoves(MoveList& moves)
 {
-	std::optional<Move> ttMove = tt.getStoredMove(board, false);
 	int color = board.getTurnColor();
 
 	// create map of enemy pawn attacks
 	U64 pawnAttacks = BB::pawnAnyAttacks(board.getPiecesBB()[PAWN + !color], !color);
 
-	std::vector<Move> newMoves;
-	for (Move& move : moves)
+	for (int i = 0; i < moves.size(); i++)
 	{
-		move.score = 0;
+		Move move = moves[i];
+		int piece = board.getMovedPiece(move);
+		int cPiece = board.getCapturedPiece(move);
+		int score = 0;
 
 		// if there's a capture award more valuable captured piece and less valuable moved piece
-		if (move.cPiece != EMPTY)
+		if (cPiece != EMPTY)
 		{
-			move.score += 15 * getPieceValue(move.cPiece) - getPieceValue(move.piece);
+			score += 15 * getPieceValue(cPiece) - getPieceValue(piece);
 		}
 
 		// award promotion with value of promotion piece
-		if (move.promotion != EMPTY)
+		if (move.isPromotion())
 		{
-			move.score += getPieceValue(move.promotion);
+			score += getPieceValue(move.getPromotionType() + color);
 		}
 
 		// if enemy pawn could take piece, penalize a more valuable piece
-		if ((pawnAttacks & (U64(1) << move.to)) > 0)
+		if ((pawnAttacks & (U64(1) << move.getTo())) > 0)
 		{
-			move.score -= getPieceValue(move.piece);
+			score -= getPieceValue(piece);
 		}
 
+		moves.score(i) = score;
+	}
+}
+
+// order list of moves from best to worst
+void Evaluation::orderMoves(MoveList& moves)
+{
+	std::optional<Move> ttMove = tt.getStoredMove(board.getZobristKey(), false);
+	scoreMoves(moves);
+
+	for (int j = 0; j < moves.size(); j++)
+	{
 		// if this was the best move in the transposition table with a lower depth, examine it first
-		if (ttMove.has_value() && move == *ttMove)
+		if (ttMove.has_value() && moves[j] == *ttMove)
 		{
-			move.score = 100000;
+			moves.score(j) = 100000;
 		}
 
-		// insert it in the right place in the sorted array
-		size_t i;
-		for (i = 0; (i < newMoves.size()) && (move.score < newMoves[i].score); i++);
-		newMoves.insert(newMoves.begin() + i, move);
+		// insert it in the right place in the already sorted part of the list
+		int i;
+		for (i = 0; (i < j) && (moves.score(j) < moves.score(i)); i++);
+		for (int k = j; k > i; k--)
+		{
+			moves.swap(k, k - 1);
+		}
 	}
-
-	moves = newMoves;
 }
 
 // count material of both colors
-std::array<int, 2> Evaluation::countMaterial(std::array<PieceList, 12>& pieceLists)
+std::array<int, 2> Evaluation::countMaterial(const std::array<U64, 12>& piecesBB)
 {
 	std::array<int, 2> material = { 0, 0 };
 	for (int i = 0; i < 12; i++)
@@ -231,7 +247,7 @@ std::array<int, 2> Evaluation::countMaterial(std::array<PieceList, 12>& pieceLis
 		if (Piece::typeOf(i) != KING)
 		{
 			// add piece count times piece value
-			material[Piece::colorOf(i)] += pieceLists[i].getCount() * getPieceValue(i);
+			material[Piece::colorOf(i)] += BB::popCount(piecesBB[i]) * getPieceValue(i);
 		}
 	}
 
@@ -251,17 +267,18 @@ double Evaluation::getEndgameWeight(std::array<int, 2> material)
 }
 
 // calculate piece square eval
-int Evaluation::countPieceSquareEval(std::array<PieceList, 12>& pieceLists, int color, double endgameWeight)
+int Evaluation::countPieceSquareEval(const std::array<U64, 12>& piecesBB, int color, double endgameWeight)
 {
 	// add up all piece square scores of ally pieces and substract scores of enemy pieces
 	int pieceSquareEval = 0;
 	for (int i = 0; i < 12; i++)
 	{
-		PieceList pieceList = pieceLists[i];
-
-		for (int j = 0; j < pieceList.getCount(); j++)
+		U64 pieces = piecesBB[i];
+		while (pieces != 0)
 		{
-			pieceSquareEval += pieceSquareTables.getScore(i, pieceList[j], endgameWeight) * (Piece::colorOf(i) == color ? 1 : -1);
+			int square = BB::bitScanForward(pieces);
+			pieces &= pieces - 1;
+			pieceSquareEval += pieceSquareTables.getScore(i, square, endgameWeight) * (Piece::colorOf(i) == color ? 1 : -1);
 		}
 	}
 
@@ -269,11 +286,11 @@ int Evaluation::countPieceSquareEval(std::array<PieceList, 12>& pieceLists, int
 }
 
 // calculate mop up eval
-int Evaluation::countMopUpEval(std::array<PieceList, 12>& pieceLists, int materialEval, double endgameWeight)
+int Evaluation::countMopUpEval(const std::array<U64, 12>& piecesBB, int materialEval, double endgameWeight)
 {
 	// get squares of white and black king, calculate their distance
-	int whiteKing = pieceLists[WHITE + KING][0];
-	int blackKing = pieceLists[BLACK + KING][0];
+	int whiteKing = BB::bitScanForward(piecesBB[WHITE + KING]);
+	int blackKing = BB::bitScanForward(piecesBB[BLACK + KING]);
 	int closeness = 14 - (std::abs(Square::fileOf(whiteKing) - Square::fileOf(blackKing)) + std::abs(Square::rankOf(whiteKing) - Square::rankOf(blackKing)));
 	int mopUpEval = 0;
 
@@ -282,26 +299,29 @@ int Evaluation::countMopUpEval(std::array<PieceList, 12>& pieceLists, int materi
 }
 
 // apply a penalty for knights in open positions
-int Evaluation::countKnightPawnPenalty(std::array<PieceList, 12>& pieceLists, int color)
+int Evaluation::countKnightPawnPenalty(const std::array<U64, 12>& piecesBB, int color)
 {
 	std::array<int, 2> knightPawnPenalty = { 0, 0 };
-	int pawnCount = pieceLists[WHITE + PAWN].getCount() + pieceLists[BLACK + PAWN].getCount();
+	int pawnCount = BB::popCount(piecesBB[WHITE + PAWN] | piecesBB[BLACK + PAWN]);
 	for (int col = 0; col < 2; col++)
 	{
-		knightPawnPenalty[col] = (int)(pieceLists[col + KNIGHT].getCount() * (16 - pawnCount) * 1);
+		knightPawnPenalty[col] = (int)(BB::popCount(piecesBB[col + KNIGHT]) * (16 - pawnCount) * 1);
 	}
 	return -(knightPawnPenalty[color] - knightPawnPenalty[!color]);
 }
 
 // apply a penalty for bishops on the same color as many pawns
-int Evaluation::countBadBishopPenalty(std::array<PieceList, 12>& pieceLists, std::array<U64, 12>& piecesBB, int color)
+int Evaluation::countBadBishopPenalty(const std::array<U64, 12>& piecesBB, int color)
 {
 	std::array<int, 2> badBishopPenalty = { 0, 0 };
 	for (int col = 0; col < 2; col++)
 	{
-		for (int i = 0; i < pieceLists[col + BISHOP].getCount(); i++)
+		U64 bishops = piecesBB[col + BISHOP];
+		while (bishops != 0)
 		{
-			U64 sameColorBB = Square::isLight(pieceLists[col + BISHOP][i]) ? 0xAA55AA55AA55AA55 : 0x55AA55AA55AA55AA;
+			int square = BB::bitScanForward(bishops);
+			bishops &= bishops - 1;
+			U64 sameColorBB = Square::isLight(square) ? 0xAA55AA55AA55AA55 : 0x55AA55AA55AA55AA;
 			badBishopPenalty[col] += (int)((BB::popCount(piecesBB[col + PAWN] & sameColorBB) - 4) * 9);
 		}
 	}
@@ -309,91 +329,156 @@ int Evaluation::countBadBishopPenalty(std::array<PieceList, 12>& pieceLists, std
 }
 
 // apply a reward for bishop pairs
-int Evaluation::countBishopPairReward(std::array<PieceList, 12>& pieceLists, int color)
+int Evaluation::countBishopPairReward(const std::array<U64, 12>& piecesBB, int color)
 {
 	std::array<int, 2> bishopPairReward = { 0, 0 };
 	for (int col = 0; col < 2; col++)
 	{
-		bishopPairReward[col] = pieceLists[col + BISHOP].getCount() >= 2 ? 37 : 0;
+		bishopPairReward[col] = BB::popCount(piecesBB[col + BISHOP]) >= 2 ? 37 : 0;
 	}
 	return bishopPairReward[color] - bishopPairReward[!color];
 }
 
+#if defined(CPU_X86)
+// shift both lanes one file to the west or east, or one rank to the north
+static __m128i shiftWest(__m128i x) { return _mm_srli_epi64(_mm_and_si128(x, _mm_set1_epi64x((I64)0xFEFEFEFEFEFEFEFE)), 1); }
+static __m128i shiftEast(__m128i x) { return _mm_slli_epi64(_mm_and_si128(x, _mm_set1_epi64x((I64)0x7F7F7F7F7F7F7F7F)), 1); }
+static __m128i shiftNorth(__m128i x) { return _mm_srli_epi64(x, 8); }
+
+// fill both lanes to the north or south, including the original squares
+static __m128i fillNorth(__m128i x)
+{
+	x = _mm_or_si128(x, _mm_srli_epi64(x, 8));
+	x = _mm_or_si128(x, _mm_srli_epi64(x, 16));
+	return _mm_or_si128(x, _mm_srli_epi64(x, 32));
+}
+
+static __m128i fillSouth(__m128i x)
+{
+	x = _mm_or_si128(x, _mm_slli_epi64(x, 8));
+	x = _mm_or_si128(x, _mm_slli_epi64(x, 16));
+	return _mm_or_si128(x, _mm_slli_epi64(x, 32));
+}
+
+// get the lanes of a vector
+static std::array<U64, 2> toLanes(__m128i x)
+{
+	return { (U64)_mm_cvtsi128_si64(x), (U64)_mm_cvtsi128_si64(_mm_unpackhi_epi64(x, x)) };
+}
+#endif
+
+// calculate the pawn structure of both colors at once, every fill is computed once and shared by the terms
+// black's pawns are flipped vertically, so that both colors move north and share the same shifts (one color in each 128 bit SIMD lane)
+PawnStructure Evaluation::getPawnStructure(U64 whitePawns, U64 blackPawns)
+{
+	PawnStructure structure;
+	std::array<U64, 2> fileFills;
+
+#if defined(CPU_X86)
+	__m128i own = _mm_set_epi64x((I64)BB::flipVertical(blackPawns), (I64)whitePawns);
+	__m128i enemy = _mm_set_epi64x((I64)BB::flipVertical(whitePawns), (I64)blackPawns);
+
+	// front spans of the own pawns and of the enemy pawns (which move south from the own color's perspective)
+	__m128i frontSpans = shiftNorth(fillNorth(own));
+	__m128i enemySpans = _mm_slli_epi64(fillSouth(enemy), 8);
+	__m128i attackSpans = _mm_or_si128(shiftWest(frontSpans), shiftEast(frontSpans));
+	__m128i enemyAttacks = _mm_or_si128(shiftWest(_mm_slli_epi64(enemy, 8)), shiftEast(_mm_slli_epi64(enemy, 8)));
+	__m128i files = _mm_or_si128(fillNorth(own), fillSouth(own));
+
+	std::array<U64, 2> doubled = toLanes(_mm_and_si128(own, frontSpans));
+	std::array<U64, 2> isolated = toLanes(_mm_andnot_si128(_mm_or_si128(shiftWest(files), shiftEast(files)), own));
+	std::array<U64, 2> passed = toLanes(_mm_andnot_si128(_mm_or_si128(enemySpans, _mm_or_si128(shiftWest(enemySpans), shiftEast(enemySpans))), own));
+	std::array<U64, 2> backwardStops = toLanes(_mm_and_si128(_mm_andnot_si128(attackSpans, shiftNorth(own)), enemyAttacks));
+	fileFills = toLanes(files);
+#else
+	std::array<U64, 2> own = { whitePawns, BB::flipVertical(blackPawns) };
+	std::array<U64, 2> enemy = { blackPawns, BB::flipVertical(whitePawns) };
+	std::array<U64, 2> doubled, isolated, passed, backwardStops;
+
+	for (int col = 0; col < 2; col++)
+	{
+		U64 frontSpans = BB::dirFill<NORTH>(own[col], true);
+		U64 enemySpans = BB::dirFill<SOUTH>(enemy[col], true);
+		U64 attackSpans = BB::shift<WEST>(frontSpans) | BB::shift<EAST>(frontSpans);
+		U64 enemyAttacks = BB::pawnAnyAttacks(enemy[col], BLACK);
+		fileFills[col] = BB::fileFill(own[col]);
+
+		doubled[col] = own[col] & frontSpans;
+		isolated[col] = own[col] & ~(BB::shift<WEST>(fileFills[col]) | BB::shift<EAST>(fileFills[col]));
+		passed[col] = own[col] & ~(enemySpans | BB::shift<WEST>(enemySpans) | BB::shift<EAST>(enemySpans));
+		backwardStops[col] = BB::shift<NORTH>(own[col]) & ~attackSpans & enemyAttacks;
+	}
+#endif
+
+	// flip black's bitboards back (file fills are symmetric)
+	structure.doubled = { doubled[WHITE], BB::flipVertical(doubled[BLACK]) };
+	structure.isolated = { isolated[WHITE], BB::flipVertical(isolated[BLACK]) };
+	structure.passed = { passed[WHITE], BB::flipVertical(passed[BLACK]) };
+	structure.backwardStops = { backwardStops[WHITE], BB::flipVertical(backwardStops[BLACK]) };
+	structure.openFiles = ~(fileFills[WHITE] | fileFills[BLACK]);
+	return structure;
+}
+
 // apply a reward for rooks standing on open files
-int Evaluation::countRookOpenFileReward(std::array<U64, 12>& piecesBB, int color)
+int Evaluation::countRookOpenFileReward(const std::array<U64, 12>& piecesBB, const PawnStructure& pawns, int color)
 {
 	std::array<int, 2> openFileReward = { 0, 0 };
 	for (int col = 0; col < 2; col++)
 	{
-		U64 openFiles = ~BB::fileFill(piecesBB[col + PAWN] | piecesBB[!col + PAWN]);
-		openFileReward[col] = (int)(BB::popCount(piecesBB[col + ROOK] & openFiles) * 37);
+		openFileReward[col] = (int)(BB::popCount(piecesBB[col + ROOK] & pawns.openFiles) * 37);
 	}
 	return openFileReward[color] - openFileReward[!color];
 }
 
 // apply a penalty for every doubled pawn
-int Evaluation::countDoubledPawnPenalty(std::array<U64, 12>& piecesBB, int color)
+int Evaluation::countDoubledPawnPenalty(const PawnStructure& pawns, int color)
 {
 	std::array<int, 2> doubledPawnPenalty = { 0, 0 };
 	for (int col = 0; col < 2; col++)
 	{
-		// any pawns that are north of ally pawns are counted
-		U64 doubledPawns = piecesBB[col + PAWN] & BB::dirFill(piecesBB[col + PAWN], NORTH, true);
-		doubledPawnPenalty[col] = (int)(BB::popCount(doubledPawns) * -21);
+		doubledPawnPenalty[col] = (int)(BB::popCount(pawns.doubled[col]) * -21);
 	}
 	return -(doubledPawnPenalty[color] - doubledPawnPenalty[!color]);
 }
 
 // apply a penalty for isolated pawns
-int Evaluation::countIsolatedPawnPenalty(std::array<U64, 12>& piecesBB, int color)
+int Evaluation::countIsolatedPawnPenalty(const PawnStructure& pawns, int color)
 {
 	std::array<int, 2> isolatedPawnPenalty = { 0, 0 };
 	for (int col = 0; col < 2; col++)
 	{
-		// pawns that are not on the sides of any ally pawns are counted
-		U64 isolatedPawns = piecesBB[col + PAWN] & ~BB::fileFill(BB::shiftTwo(piecesBB[col + PAWN], WEST)) & ~BB::fileFill(BB::shiftTwo(piecesBB[col + PAWN], EAST));
-		isolatedPawnPenalty[col] = (int)(BB::popCount(isolatedPawns) * 8);
+		isolatedPawnPenalty[col] = (int)(BB::popCount(pawns.isolated[col]) * 8);
 	}
 	return -(isolatedPawnPenalty[color] - isolatedPawnPenalty[!color]);
 }
 
 // apply a reward for passed pawns
-int Evaluation::countPassedPawnReward(std::array<U64, 12>& piecesBB, int color)
+int Evaluation::countPassedPawnReward(const PawnStructure& pawns, int color)
 {
 	std::array<int, 2> passedPawnReward = { 0, 0 };
 	for (int col = 0; col < 2; col++)
 	{
-		// pawns that are not in the front spans of enemy pawns are counted
-		U64 allFrontSpans = BB::dirFill(piecesBB[!col + PAWN], col == WHITE ? SOUTH : NORTH, true);
-		allFrontSpans |= BB::shiftTwo(allFrontSpans, WEST) | BB::shiftTwo(allFrontSpans, EAST);
-		U64 passedPawns = piecesBB[col + PAWN] & ~allFrontSpans;
-		passedPawnReward[col] = (int)(BB::popCount(passedPawns) * 37);
+		passedPawnReward[col] = (int)(BB::popCount(pawns.passed[col]) * 37);
 	}
 	return passedPawnReward[color] - passedPawnReward[!color];
 }
 
 // apply a penalty for backward pawns
-int Evaluation::countBackwardPawnPenalty(std::array<U64, 12>& piecesBB, int color)
+int Evaluation::countBackwardPawnPenalty(const PawnStructure& pawns, int color)
 {
 	std::array<int, 2> backwardPawnPenalty = { 0, 0 };
 	for (int col = 0; col < 2; col++)
 	{
-		// pawns that aren't backed by any ally pawns but can't pass due to enemy pawn attacks are counted
-		U64 stops = BB::shiftTwo(piecesBB[col + PAWN], col == WHITE ? NORTH : SOUTH);
-		U64 frontSpans = BB::dirFill(piecesBB[col + PAWN], col == WHITE ? NORTH : SOUTH, true);
-		U64 attackSpans = BB::shiftTwo(frontSpans, WEST) | BB::shiftTwo(frontSpans, EAST);
-		U64 enemyAttacks = BB::pawnAnyAttacks(piecesBB[!col + PAWN], !col);
-		U64 backwardPawnStops = stops & ~attackSpans & enemyAttacks;
-		backwardPawnPenalty[col] = (int)(BB::popCount(backwardPawnStops) * 11);
+		backwardPawnPenalty[col] = (int)(BB::popCount(pawns.backwardStops[col]) * 11);
 	}
 	return -(backwardPawnPenalty[color] - backwardPawnPenalty[!color]);
 }
 
 // apply a reward for pawn shields
-int Evaluation::countPawnShieldEval(std::array<PieceList, 12>& pieceLists, std::array<U64, 12>& piecesBB, int color, double openingWeight, double endgameWeight)
+int Evaluation::countPawnShieldEval(const std::array<U64, 12>& piecesBB, int color, double openingWeight, double endgameWeight)
 {
-	int allyKingFile = Square::fileOf(pieceLists[color + KING][0]);
-	int enemyKingFile = Square::fileOf(pieceLists[!color + KING][0]);
+	int allyKingFile = Square::fileOf(BB::bitScanForward(piecesBB[color + KING]));
+	int enemyKingFile = Square::fileOf(BB::bitScanForward(piecesBB[!color + KING]));
 	int allyKingWing = allyKingFile / 4;
 	int enemyKingWing = enemyKingFile / 4;
 	bool allyKingInMiddle = allyKingFile > 2 && allyKingFile < 5;
@@ -409,11 +494,11 @@ int Evaluation::countPawnShieldEval(std::array<PieceList, 12>& pieceLists, std::
 }
 
 // apply a penalty for enemy pawn storms
-int Evaluation::countPawnStormEval(std::array<PieceList, 12>& pieceLists, std::array<U64, 12>& piecesBB, int color, double endgameWeight)
+int Evaluation::countPawnStormEval(const std::array<U64, 12>& piecesBB, int color, double endgameWeight)
 {
 	// count how many enemy pawns are near the kings
-	int allyPawnStorm = BB::popCount(nearKingSquares[pieceLists[color + KING][0]] & piecesBB[!color + PAWN]);
-	int enemyPawnStorm = BB::popCount(nearKingSquares[pieceLists[!color + KING][0]] & piecesBB[color + PAWN]);
+	int allyPawnStorm = BB::popCount(nearKingSquares[BB::bitScanForward(piecesBB[color + KING])] & piecesBB[!color + PAWN]);
+	int enemyPawnStorm = BB::popCount(nearKingSquares[BB::bitScanForward(piecesBB[!color + KING])] & piecesBB[color + PAWN]);
 	int pawnStormEval = (int)((enemyPawnStorm - allyPawnStorm) * 1.4 * std::max(0.0, 1 - endgameWeight * 1.5));
 	return pawnStormEval;
 }
@@ -421,29 +506,30 @@ int Evaluation::countPawnStormEval(std::array<PieceList, 12>& pieceLists, std::a
 // main evaluation function
 int Evaluation::evaluate()
 {
-	// save turn color and piece lists
+	// save turn color and bitboards
 	int color = board.getTurnColor();
-	std::array<PieceList, 12> pieceLists = board.getPieceLists();
-	std::array<U64, 12> piecesBB = board.getPiecesBB();
+	const std::array<U64, 12>& piecesBB = board.getPiecesBB();
 
-	// calculate helper functions
+	// calculate helper functions, material information is looked up by the board's material key
+	MaterialEntry materialEntry = board.getMaterialEntry();
 	double openingWeight = getOpeningWeight();
-	double endgameWeight = getEndgameWeight(material);
+	double endgameWeight = materialEntry.endgameWeight;
+	PawnStructure pawns = getPawnStructure(piecesBB[WHITE + PAWN], piecesBB[BLACK + PAWN]);
 
 	// calculate eval parts
-	int materialEval = material[color] - material[!color];
+	int materialEval = materialEntry.imbalance * (color == WHITE ? 1 : -1);
 	int pieceSquareEval = whitePieceSquareEval * (color == WHITE ? 1 : -1);
-	int mopUpEval = countMopUpEval(pieceLists, materialEval, endgameWeight);
-	int knightPawnPenalty = countKnightPawnPenalty(pieceLists, color);
-	int badBishopPenalty = countBadBishopPenalty(pieceLists, piecesBB, color);
-	int bishopPairReward = countBishopPairReward(pieceLists, color);
-	int rookOpenFileReward = countRookOpenFileReward(piecesBB, color);
-	int doubledPawnPenalty = countDoubledPawnPenalty(piecesBB, color);
-	int isolatedPawnPenalty = countIsolatedPawnPenalty(piecesBB, color);
-	int passedPawnReward = countPassedPawnReward(piecesBB, color);
-	int backwardPawnPenalty = countBackwardPawnPenalty(piecesBB, color);
-	int pawnShieldEval = countPawnShieldEval(pieceLists, piecesBB, color, openingWeight, endgameWeight);
-	int pawnStormEval = countPawnStormEval(pieceLists, piecesBB, color, endgameWeight);
+	int mopUpEval = countMopUpEval(piecesBB, materialEval, endgameWeight);
+	int knightPawnPenalty = countKnightPawnPenalty(piecesBB, color);
+	int badBishopPenalty = countBadBishopPenalty(piecesBB, color);
+	int bishopPairReward = countBishopPairReward(piecesBB, color);
+	int rookOpenFileReward = countRookOpenFileReward(piecesBB, pawns, color);
+	int doubledPawnPenalty = countDoubledPawnPenalty(pawns, color);
+	int isolatedPawnPenalty = countIsolatedPawnPenalty(pawns, color);
+	int passedPawnReward = countPassedPawnReward(pawns, color);
+	int backwardPawnPenalty = countBackwardPawnPenalty(pawns, color);
+	int pawnShieldEval = countPawnShieldEval(piecesBB, color, openingWeight, endgameWeight);
+	int pawnStormEval = countPawnStormEval(piecesBB, color, endgameWeight);
 
 	// return sum of eval parts
 	return materialEval + pieceSquareEval + mopUpEval + knightPawnPenalty + badBishopPenalty + bishopPairReward + rookOpenFileReward + doubledPawnPenalty + isolatedPawnPenalty + passedPawnReward + backwardPawnPenalty + pawnShieldEval + pawnStormEval;
@@ -6,28 +6,38 @@
 #include "TranspositionTable.h"
 #include "PieceSquareTables.h"
 
+#if defined(CPU_X86)
+#include <emmintrin.h>
+#endif
+
+// pawn structure of both colors, indexed by color
+struct PawnStructure
+{
+	std::array<U64, 2> doubled; // pawns with an ally pawn behind them on the same file
+	std::array<U64, 2> isolated; // pawns without ally pawns on the neighbouring files
+	std::array<U64, 2> passed; // pawns without enemy pawns in front of them on the same or neighbouring files
+	std::array<U64, 2> backwardStops; // stop squares of pawns which can't be supported by ally pawns and are attacked by enemy pawns
+	U64 openFiles; // files without any pawns
+};
 
 class Evaluation
 {
 	Board& board;
 	TranspositionTable& tt;
 
-	std::array<int, 14> pieceValues;
+	static const std::array<int, 14> pieceValues;
 	PieceSquareTables pieceSquareTables;
 
-	// pawn shield bitboards for each color and wing
-	std::array<std::array<U64, 2>, 2> pawnShieldBBs;
-	std::array<U64, 64> nearKingSquares;
+	// pawn shield bitboards for each color and wing, king zone for every square
+	static const std::array<std::array<U64, 2>, 2> pawnShieldBBs;
+	static const std::array<U64, 64> nearKingSquares;
 
-	std::array<U64, 8> fileBBs;
+	static const std::array<U64, 8> fileBBs;
 
 	// evaluation terms
 	double oldEndgameWeight;
 	std::array<int, 2> material;
 	int whitePieceSquareEval;
-	std::stack<std::array<int, 2>> materialHistory;
-	std::stack<int> whitePieceSquareHistory;
-	std::stack<double> endgameWeightHistory;
 
 public:
 	Evaluation(Board& boardPar, TranspositionTable& ttPar);
@@ -35,29 +45,31 @@ public:
 	// initial eval in new position, actions to change eval
 	void reloadEval();
 	void makeMove(Move move);
-	void unmakeMove(Move move);
+	void unmakeMove();
 
-	void orderMoves(std::vector<Move>& moves);
+	void scoreMoves(MoveList& moves);
+	void orderMoves(MoveList& moves);
 
 	// evaluation helper functions
-	int getPieceValue(int piece);
-	std::array<int, 2> countMaterial(std::array<PieceList, 12>& pieceLists);
+	static int getPieceValue(int piece);
+	static PawnStructure getPawnStructure(U64 whitePawns, U64 blackPawns);
+	std::array<int, 2> countMaterial(const std::array<U64, 12>& piecesBB);
 	double getOpeningWeight();
-	double getEndgameWeight(std::array<int, 2> material);
+	static double getEndgameWeight(std::array<int, 2> material);
 
 	// part evaluation functions
-	int countPieceSquareEval(std::array<PieceList, 12>& pieceLists, int color, double endgameWeight);
-	int countMopUpEval(std::array<PieceList, 12>& pieceLists, int materialEval, double endgameWeight);
-	int countKnightPawnPenalty(std::array<PieceList, 12>& pieceLists, int color);
-	int countBadBishopPenalty(std::array<PieceList, 12>& pieceLists, std::array<U64, 12>& piecesBB, int color);
-	int countBishopPairReward(std::array<PieceList, 12>& pieceLists, int color);
-	int countRookOpenFileReward(std::array<U64, 12>& piecesBB, int color);
-	int countDoubledPawnPenalty(std::array<U64, 12>& piecesBB, int color);
-	int countIsolatedPawnPenalty(std::array<U64, 12>& piecesBB, int color);
-	int countPassedPawnReward(std::array<U64, 12>& piecesBB, int color);
-	int countBackwardPawnPenalty(std::array<U64, 12>& piecesBB, int color);
-	int countPawnShieldEval(std::array<PieceList, 12>& pieceLists, std::array<U64, 12>& piecesBB, int color, double openingWeight, double endgameWeight);
-	int countPawnStormEval(std::array<PieceList, 12>& pieceLists, std::array<U64, 12>& piecesBB, int color, double endgameWeight);
+	int countPieceSquareEval(const std::array<U64, 12>& piecesBB, int color, double endgameWeight);
+	int countMopUpEval(const std::array<U64, 12>& piecesBB, int materialEval, double endgameWeight);
+	int countKnightPawnPenalty(const std::array<U64, 12>& piecesBB, int color);
+	int countBadBishopPenalty(const std::array<U64, 12>& piecesBB, int color);
+	int countBishopPairReward(const std::array<U64, 12>& piecesBB, int color);
+	int countRookOpenFileReward(const std::array<U64, 12>& piecesBB, const PawnStructure& pawns, int color);
+	int countDoubledPawnPenalty(const PawnStructure& pawns, int color);
+	int countIsolatedPawnPenalty(const PawnStructure& pawns, int color);
+	int countPassedPawnReward(const PawnStructure& pawns, int color);
+	int countBackwardPawnPenalty(const PawnStructure& pawns, int color);
+	int countPawnShieldEval(const std::array<U64, 12>& piecesBB, int color, double openingWeight, double endgameWeight);
+	int countPawnStormEval(const std::array<U64, 12>& piecesBB, int color, double endgameWeight);
 
 	// main evaluation function
 	int evaluate();
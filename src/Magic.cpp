@@ -0,0 +1,224 @@
+#include "Magic.h"
+
+std::array<MagicEntry, 64> Magic::rookEntries;
+std::array<MagicEntry, 64> Magic::bishopEntries;
+std::vector<U64> Magic::rookTable;
+std::vector<U64> Magic::bishopTable;
+
+// magic numbers found by a random search for sparse numbers, they map every relevant occupancy of a square without destructive collisions
+constexpr std::array<U64, 64> Magic::rookMagics = {
+	0x0200108100420020, 0x0040002000100040, 0x0280100020018089, 0x0B00081003002004,
+	0x2A00200810040200, 0x0300030004000802, 0x0300440181000600, 0x0200084082010424,
+	0x0000800080204006, 0x0000808040002000, 0x0030802000801000, 0x000A801004080080,
+	0x8024808038004400, 0x0002800200812400, 0x0104000108100204, 0x000200204284030A,
+	0x1040008000804020, 0x8040010041002080, 0x1001010040200010, 0x0000808008001000,
+	0x1010050008010010, 0xC040080110042040, 0x0802440008020110, 0x0401020000804401,
+	0x0850208080004000, 0xC840004040201000, 0x90C0200280100081, 0x1210001080080480,
+	0x0300080100041100, 0x2000040080020080, 0x0000010400100882, 0x8020104600029403,
+	0x0080004000402000, 0x0000804202002104, 0x0001801002802000, 0x0008801000800800,
+	0x0C010004B1002800, 0x0040800400800200, 0x8308E10824001002, 0x5184204402000081,
+	0x0280800041030028, 0x2010044220044008, 0x8000402001010012, 0x8003001000090020,
+	0x8000080004008080, 0x9802001004020008, 0x4100020001008080, 0x0000040080420001,
+	0xA200932045020200, 0x0838400084200080, 0x0000200180900280, 0x02C4200810010100,
+	0x4001800800040180, 0x0530040002008080, 0x00A3008402000100, 0xA004104100840200,
+	0x0000800040201901, 0x0809504280620102, 0x0044100820030041, 0x0006000408401022,
+	0x2002010408102002, 0x0402006104083002, 0x051421121000880C, 0x1070888C01410722
+};
+
+constexpr std::array<U64, 64> Magic::bishopMagics = {
+	0x0040110801044180, 0x4984040444102500, 0x00320C0401242810, 0x0004410020008800,
+	0x0104042200246840, 0x0003040340800000, 0x0802840528404010, 0x264080280202208A,
+	0x0000400224540080, 0x0000200414208029, 0x0520100902057A00, 0x0809080A00200900,
+	0x1040440308000042, 0x0000020105202140, 0x0510095C02084148, 0x8000208200822000,
+	0x00C0083114388080, 0x0010813210020088, 0x0004000800202200, 0x1012001040104004,
+	0x040C0002021A0060, 0x0002001B05008200, 0x8010800044046000, 0x0800209086080220,
+	0x82042413A0385000, 0x4044600010010900, 0x0002020C44440402, 0x1008080000202120,
+	0x00C0840010802000, 0x0408049002004404, 0x4A88820000881400, 0xC244009028220520,
+	0x02C4840488202000, 0x0404300822020212, 0x02B2042E00100080, 0x0200600800050051,
+	0x1204180200902008, 0x0010005600804104, 0x2084A80448220110, 0x002A028102012400,
+	0x0801100904042000, 0x03004210840010A4, 0x1042001404025A04, 0x8708004208000080,
+	0x08C282020A054400, 0x0004008802020040, 0x02500220D400A100, 0x0414010401088220,
+	0x8620820120214008, 0x0012004208042004, 0x0040118448082004, 0x4488080042022004,
+	0x0000004005010100, 0x0000500210410902, 0x0010028808008000, 0x0820024408428046,
+	0x0201228844104000, 0x080204210C102409, 0x0104100022011048, 0x0030084000420210,
+	0x1200082C20085040, 0x0860080490021200, 0x0000C08208010510, 0x014811080A140122
+};
+
+// initialize tables at program start (after the tables above have been constructed)
+static bool magicInitialized = Magic::init();
+
+// calculate sliding attacks square by square, only used for initialization
+U64 Magic::slidingAttacks(int square, U64 occupied, bool rook)
+{
+	// file and rank steps of the four directions of the piece
+	std::array<std::array<int, 2>, 4> steps = rook ? std::array<std::array<int, 2>, 4>{ { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } } }
+	                                              : std::array<std::array<int, 2>, 4>{ { { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } } };
+
+	U64 attacks = U64(0);
+	for (std::array<int, 2> step : steps)
+	{
+		int file = Square::fileOf(square) + step[0];
+		int rank = Square::rankOf(square) + step[1];
+
+		// cast ray until the border or a taken square is reached
+		while (file >= 0 && file < 8 && rank >= 0 && rank < 8)
+		{
+			U64 squareBB = U64(1) << Square::fromCoords(file, rank);
+			attacks |= squareBB;
+
+			if (occupied & squareBB)
+			{
+				break;
+			}
+
+			file += step[0];
+			rank += step[1];
+		}
+	}
+
+	return attacks;
+}
+
+// fill attack table for rooks or bishops
+void Magic::initPiece(std::array<MagicEntry, 64>& entries, std::vector<U64>& table, const std::array<U64, 64>& magics, bool rook)
+{
+	int offset = 0;
+
+	table.clear();
+
+	for (int square = 0; square < 64; square++)
+	{
+		// edges don't matter for occupancy if the piece isn't on them
+		U64 rankEdges = U64(0xFF000000000000FF) & ~(U64(0xFF) << (Square::rankOf(square) * 8));
+		U64 fileEdges = U64(0x8181818181818181) & ~(U64(0x0101010101010101) << Square::fileOf(square));
+		U64 mask = slidingAttacks(square, U64(0), rook) & ~(rankEdges | fileEdges);
+
+		// with PEXT the extracted bits are a perfect index, no magic number needed
+		MagicEntry& entry = entries[square];
+		entry.mask = mask;
+		entry.magic = Cpu::pext ? U64(0) : magics[square];
+		entry.shift = 64 - BB::popCount(mask);
+		entry.offset = offset;
+
+		// enumerate all subsets of the mask (Carry-Rippler trick) and save their attacks
+		int size = 1 << BB::popCount(mask);
+		table.resize(offset + size);
+
+		U64 subset = U64(0);
+		do
+		{
+			table[entry.index(subset)] = slidingAttacks(square, subset, rook);
+			subset = (subset - mask) & mask;
+		} while (subset != 0);
+
+		offset += size;
+	}
+}
+
+#if defined(CPU_X86)
+// lane constants for filling in four directions at once
+struct FillLanes
+{
+	std::array<I64, 4> leftShifts; // shift amount for positive directions, 64 (giving 0) otherwise
+	std::array<I64, 4> rightShifts; // shift amount for negative directions, 64 (giving 0) otherwise
+	std::array<U64, 4> wrapMasks; // squares which can't be reached because the shift would wrap around the board
+};
+
+static constexpr FillLanes createFillLanes(std::array<int, 4> shifts)
+{
+	FillLanes lanes = {};
+	for (int i = 0; i < 4; i++)
+	{
+		int horizontal = (shifts[i] % 8 + 8) % 8;
+		lanes.leftShifts[i] = (shifts[i] > 0) ? shifts[i] : 64;
+		lanes.rightShifts[i] = (shifts[i] < 0) ? -shifts[i] : 64;
+		lanes.wrapMasks[i] = (horizontal == 1) ? ~U64(0x0101010101010101) : (horizontal == 7) ? ~U64(0x8080808080808080) : ~U64(0);
+	}
+
+	return lanes;
+}
+
+static constexpr FillLanes rookLanes = createFillLanes({ EAST, SOUTH, WEST, NORTH });
+static constexpr FillLanes bishopLanes = createFillLanes({ SOUTH_EAST, SOUTH_WEST, NORTH_EAST, NORTH_WEST });
+
+// shift every lane by its direction times a factor of 1, 2 or 4
+TARGET_AVX2 static inline __m256i shiftLanes(__m256i x, __m256i leftShifts, __m256i rightShifts, int factorLog)
+{
+	__m256i left = _mm256_sllv_epi64(x, _mm256_slli_epi64(leftShifts, factorLog));
+	__m256i right = _mm256_srlv_epi64(x, _mm256_slli_epi64(rightShifts, factorLog));
+	return _mm256_or_si256(left, right);
+}
+
+// occluded Kogge-Stone fill of a set in four directions, one direction in each 64 bit lane (only called on AVX2 CPUs)
+TARGET_AVX2 static U64 occludedFill4(U64 set, U64 empty, const FillLanes& lanes)
+{
+	__m256i leftShifts = _mm256_loadu_si256((const __m256i*)lanes.leftShifts.data());
+	__m256i rightShifts = _mm256_loadu_si256((const __m256i*)lanes.rightShifts.data());
+	__m256i masks = _mm256_loadu_si256((const __m256i*)lanes.wrapMasks.data());
+
+	__m256i gen = _mm256_set1_epi64x((I64)set);
+	__m256i pro = _mm256_and_si256(_mm256_set1_epi64x((I64)empty), masks);
+
+	// fill by 1, 2 and 4 steps, then shift once more to get the attacks
+	gen = _mm256_or_si256(gen, _mm256_and_si256(pro, shiftLanes(gen, leftShifts, rightShifts, 0)));
+	pro = _mm256_and_si256(pro, shiftLanes(pro, leftShifts, rightShifts, 0));
+	gen = _mm256_or_si256(gen, _mm256_and_si256(pro, shiftLanes(gen, leftShifts, rightShifts, 1)));
+	pro = _mm256_and_si256(pro, shiftLanes(pro, leftShifts, rightShifts, 1));
+	gen = _mm256_or_si256(gen, _mm256_and_si256(pro, shiftLanes(gen, leftShifts, rightShifts, 2)));
+	__m256i attacks = _mm256_and_si256(shiftLanes(gen, leftShifts, rightShifts, 0), masks);
+
+	// combine the four lanes
+	__m128i half = _mm_or_si128(_mm256_castsi256_si128(attacks), _mm256_extracti128_si256(attacks, 1));
+	return (U64)_mm_cvtsi128_si64(_mm_or_si128(half, _mm_unpackhi_epi64(half, half)));
+}
+#endif
+
+// attacks of all rooks (or queens) in a set
+U64 Magic::rookSetAttacks(U64 rooks, U64 occupied)
+{
+#if defined(CPU_X86)
+	if (Cpu::avx2)
+	{
+		return occludedFill4(rooks, ~occupied, rookLanes);
+	}
+#endif
+
+	U64 attacks = U64(0);
+	for (; rooks != 0; rooks &= rooks - 1)
+	{
+		attacks |= rookAttacks(BB::bitScanForward(rooks), occupied);
+	}
+
+	return attacks;
+}
+
+// attacks of all bishops (or queens) in a set
+U64 Magic::bishopSetAttacks(U64 bishops, U64 occupied)
+{
+#if defined(CPU_X86)
+	if (Cpu::avx2)
+	{
+		return occludedFill4(bishops, ~occupied, bishopLanes);
+	}
+#endif
+
+	U64 attacks = U64(0);
+	for (; bishops != 0; bishops &= bishops - 1)
+	{
+		attacks |= bishopAttacks(BB::bitScanForward(bishops), occupied);
+	}
+
+	return attacks;
+}
+
+// initialize all tables
+bool Magic::init()
+{
+	// the table layout depends on whether PEXT is used
+	Cpu::init();
+
+	initPiece(rookEntries, rookTable, rookMagics, true);
+	initPiece(bishopEntries, bishopTable, bishopMagics, false);
+
+	return true;
+}
\ No newline at end of file
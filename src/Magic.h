@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "Bitboard.h"
+#include "Square.h"
+
+#if defined(CPU_X86)
+#include <immintrin.h>
+#endif
+
+// magic bitboard entry for one square, attacks are indexed by the relevant occupancy of the square
+struct MagicEntry
+{
+	U64 mask; // relevant occupancy (rays without edge squares)
+	U64 magic; // magic factor for hashing the occupancy
+	int shift; // 64 - number of relevant bits
+	int offset; // offset of the square's attacks in the attack table
+
+	// calculate attack table index of an occupancy, the tables are built for PEXT on CPUs with a fast PEXT
+	int index(U64 occupied) const
+	{
+		if (Cpu::pext)
+		{
+			return offset + (int)Cpu::pextInstruction(occupied, mask);
+		}
+
+		return offset + (int)(((occupied & mask) * magic) >> shift);
+	}
+};
+
+// class for looking up sliding piece attacks with magic bitboards (or PEXT on BMI2 CPUs, chosen at startup)
+class Magic
+{
+	// magic entries for every square
+	static std::array<MagicEntry, 64> rookEntries;
+	static std::array<MagicEntry, 64> bishopEntries;
+
+	// shared attack tables for all squares
+	static std::vector<U64> rookTable;
+	static std::vector<U64> bishopTable;
+
+	// precomputed magic numbers for every square (without PEXT)
+	static const std::array<U64, 64> rookMagics;
+	static const std::array<U64, 64> bishopMagics;
+
+	// helper functions for initialization
+	static U64 slidingAttacks(int square, U64 occupied, bool rook);
+	static void initPiece(std::array<MagicEntry, 64>& entries, std::vector<U64>& table, const std::array<U64, 64>& magics, bool rook);
+
+public:
+	// initialize all tables, called once at program start
+	static bool init();
+
+	// attacks of sliding pieces on a square with given occupancy
+	static U64 rookAttacks(int square, U64 occupied)
+	{
+		return rookTable[rookEntries[square].index(occupied)];
+	}
+
+	static U64 bishopAttacks(int square, U64 occupied)
+	{
+		return bishopTable[bishopEntries[square].index(occupied)];
+	}
+
+	static U64 queenAttacks(int square, U64 occupied)
+	{
+		return rookAttacks(square, occupied) | bishopAttacks(square, occupied);
+	}
+
+	// attacks of all sliding pieces in a set, the four directions are filled at once on AVX2 CPUs (one lookup per piece otherwise)
+	static U64 rookSetAttacks(U64 rooks, U64 occupied);
+	static U64 bishopSetAttacks(U64 bishops, U64 occupied);
+};
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "Material.h"
+#include "Evaluation.h"
+
+// maximum counts covered by the table, more queens, rooks, bishops or knights need promotions
+constexpr std::array<int, 12> Material::maxCounts = { 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 8, 8 };
+
+// weight of each piece in the key, generated from the maximum counts
+constexpr std::array<int, 12> Material::keyWeights = []()
+{
+	std::array<int, 12> weights = {};
+	int weight = 1;
+	for (int color : { WHITE, BLACK })
+	{
+		for (int type : { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING })
+		{
+			weights[type + color] = (type == KING) ? 0 : weight;
+			weight *= (type == KING) ? 1 : maxCounts[type + color] + 1;
+		}
+	}
+
+	return weights;
+}();
+
+std::vector<MaterialEntry> Material::table;
+
+// initialize table at program start (after the table above has been constructed)
+static bool materialInitialized = Material::init();
+
+// calculate material information, uses the same rules as the evaluation
+MaterialEntry Material::compute(std::array<int, 12> counts)
+{
+	MaterialEntry entry;
+
+	// add piece count times piece value for both colors
+	std::array<int, 2> material = { 0, 0 };
+	for (int i = 0; i < 12; i++)
+	{
+		if (Piece::typeOf(i) != KING)
+		{
+			material[Piece::colorOf(i)] += counts[i] * Evaluation::getPieceValue(i);
+		}
+	}
+
+	entry.endgameWeight = Evaluation::getEndgameWeight(material);
+	entry.imbalance = material[WHITE] - material[BLACK];
+	entry.draw = NOT_DRAWN;
+
+	// only check for insufficient material if there aren't any queens, rooks or pawns
+	if (counts[WHITE + QUEEN] + counts[BLACK + QUEEN] + counts[WHITE + ROOK] + counts[BLACK + ROOK] + counts[WHITE + PAWN] + counts[BLACK + PAWN] == 0)
+	{
+		std::array<int, 2> knights = { counts[WHITE + KNIGHT], counts[BLACK + KNIGHT] };
+		std::array<int, 2> bishops = { counts[WHITE + BISHOP], counts[BLACK + BISHOP] };
+		int minors = knights[WHITE] + knights[BLACK] + bishops[WHITE] + bishops[BLACK];
+
+		// two kings or a single minor piece can't mate
+		if (minors <= 1)
+		{
+			entry.draw = DRAWN;
+		}
+
+		// one bishop each can't mate if they are on the same color
+		if (bishops[WHITE] == 1 && bishops[BLACK] == 1 && minors == 2)
+		{
+			entry.draw = DRAWN_IF_SAME_BISHOPS;
+		}
+	}
+
+	return entry;
+}
+
+// calculate material information for every key
+bool Material::init()
+{
+	int size = 1;
+	for (int i = 0; i < 12; i++)
+	{
+		size *= maxCounts[i] + 1 - (Piece::typeOf(i) == KING);
+	}
+	table.resize(size);
+
+	for (int key = 0; key < size; key++)
+	{
+		// get the piece counts from the digits of the key
+		std::array<int, 12> counts = {};
+		for (int i = 0; i < 12; i++)
+		{
+			counts[i] = (Piece::typeOf(i) == KING) ? 1 : key / keyWeights[i] % (maxCounts[i] + 1);
+		}
+
+		table[key] = compute(counts);
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "Piece.h"
+
+// verdicts about insufficient material
+enum MaterialDraws
+{
+	NOT_DRAWN,
+	DRAWN,
+	DRAWN_IF_SAME_BISHOPS // one bishop each, drawn if they are on squares of the same color
+};
+
+// precomputed information about a material configuration
+struct MaterialEntry
+{
+	double endgameWeight; // 0 with all pieces on the board, 1 without any
+	int imbalance; // material of white minus material of black
+	int draw; // insufficient material verdict
+};
+
+// class for material keys and the table of material information indexed by them
+class Material
+{
+	// key of one piece of each type, the key is a mixed radix number of the piece counts
+	static const std::array<int, 12> keyWeights;
+
+	// highest count of each piece covered by the table
+	static const std::array<int, 12> maxCounts;
+
+	// material information for every key
+	static std::vector<MaterialEntry> table;
+
+public:
+	// initialize the table, called once at program start
+	static bool init();
+
+	// calculate material information from piece counts, needed if a count is above the maximum
+	static MaterialEntry compute(std::array<int, 12> counts);
+
+	// access methods
+	static int keyWeight(int piece) { return keyWeights[piece]; }
+	static int maxCount(int piece) { return maxCounts[piece]; }
+	static const MaterialEntry& probe(int key) { return table[key]; }
+};
\ No newline at end of file
@@ -1,12 +1,15 @@
 #include "Move.h"
+#include "Board.h"
 
-// checking if two moves are the same by checking from and to squares and promotion piece
-bool Move::operator==(Move move)
+// create move from its raw 16 bit value
+Move Move::fromData(uint16_t data)
 {
-	return (move.from == from) && (move.to == to) && (move.promotion == promotion);
+	Move move;
+	move.data = data;
+	return move;
 }
 
-// return notation of move e.g. "a1f3" or "c2c1q" 
+// return notation of move e.g. "a1f3" or "c2c1q"
 std::string Move::getNotation()
 {
 	// handle nullmoves
@@ -16,12 +19,12 @@ std::string Move::getNotation()
 	}
 
 	// concatenate from and to squares as base of move
-	std::string base = Square::toString(from) + Square::toString(to);
+	std::string base = Square::toString(getFrom()) + Square::toString(getTo());
 
 	// if there's a promotion, specify the promotion piece
-	if (promotion != -1)
+	if (isPromotion())
 	{
-		switch (Piece::typeOf(promotion))
+		switch (getPromotionType())
 		{
 		case QUEEN:
 			base += "q";
@@ -42,13 +45,11 @@ std::string Move::getNotation()
 }
 
 // load move from source and target squares
-Move Move::loadFromSquares(int from, int to, std::array<int, 64> piecesMB)
-{ 
+Move Move::loadFromSquares(int from, int to, Board& board)
+{
+	const std::array<int8_t, 64>& piecesMB = board.getPiecesMB();
 	int movedPiece = piecesMB[from];
-	int takenPiece = piecesMB[to];
-	int promotionPiece = EMPTY;
-	bool isEnPassant = false;
-	bool isCastling = false;
+	int flag = NORMAL_MOVE;
 
 	int pieceColor = Piece::colorOf(movedPiece);
 	int pieceType = Piece::typeOf(movedPiece);
@@ -56,28 +57,26 @@ Move Move::loadFromSquares(int from, int to, std::array<int, 64> piecesMB)
 	// en passant move properties
 	if ((from - to) % 8 != 0 && piecesMB[to] == EMPTY && pieceType == PAWN)
 	{
-		takenPiece = !pieceColor + PAWN;
-		isEnPassant = true;
+		flag = EN_PASSANT_MOVE;
 	}
 
 	// castling move properties
 	if (std::abs(from - to) == 2 && pieceType == KING)
 	{
-		isCastling = true;
+		flag = CASTLING_MOVE;
 	}
 
 	// promotion move properties
 	if ((Square::rankOf(to) == pieceColor * 7) && (pieceType == PAWN))
 	{
-		promotionPiece = QUEEN + pieceColor;
+		flag = PROMOTION_MOVE;
 	}
 
-	Move move = { from, to, movedPiece, takenPiece, isEnPassant, isCastling, promotionPiece, 0 };
-	return move;
+	return Move(from, to, flag);
 }
 
 // load move from long algebraic notation
-Move Move::loadFromNotation(std::string notation, std::array<int, 64> piecesMB)
+Move Move::loadFromNotation(std::string notation, Board& board)
 {
 	// handle nullmoves
 	if (notation == "0000")
@@ -87,9 +86,7 @@ Move Move::loadFromNotation(std::string notation, std::array<int, 64> piecesMB)
 
 	int from = Square::fromString(notation.substr(0, 2));
 	int to = Square::fromString(notation.substr(2, 4));
-	Move move = Move::loadFromSquares(from, to, piecesMB);
-
-	int pieceColor = Piece::colorOf(piecesMB[from]);
+	Move move = Move::loadFromSquares(from, to, board);
 
 	// handle promotion
 	if (notation.size() == 5)
@@ -97,16 +94,16 @@ Move Move::loadFromNotation(std::string notation, std::array<int, 64> piecesMB)
 		switch (notation[4])
 		{
 		case 'q':
-			move.promotion = QUEEN + pieceColor;
+			move = Move(from, to, PROMOTION_MOVE, QUEEN);
 			break;
 		case 'r':
-			move.promotion = ROOK + pieceColor;
+			move = Move(from, to, PROMOTION_MOVE, ROOK);
 			break;
 		case 'b':
-			move.promotion = BISHOP + pieceColor;
+			move = Move(from, to, PROMOTION_MOVE, BISHOP);
 			break;
 		case 'n':
-			move.promotion = KNIGHT + pieceColor;
+			move = Move(from, to, PROMOTION_MOVE, KNIGHT);
 			break;
 		}
 	}
@@ -114,11 +111,10 @@ Move Move::loadFromNotation(std::string notation, std::array<int, 64> piecesMB)
 	return move;
 }
 
-// return a null move
+// return a null move (from and to square are the same, which is impossible for any other move)
 Move Move::nullmove()
 {
-	Move newMove = { EMPTY, EMPTY, EMPTY, EMPTY, false, false, EMPTY, 0 };
-	return newMove;
+	return Move();
 }
 
 bool Move::isNull(Move move)
@@ -2,29 +2,78 @@
 #include "Square.h"
 #include "Piece.h"
 #include <array>
+#include <cstdint>
+#include <utility>
 
-// struct for a chess move
-struct Move
+class Board;
+
+// special move types
+enum MoveFlags
+{
+	NORMAL_MOVE = 0,
+	PROMOTION_MOVE = 1,
+	EN_PASSANT_MOVE = 2,
+	CASTLING_MOVE = 3
+};
+
+// class for a chess move packed into 16 bits, the moved and captured pieces are taken from the board
+class Move
 {
-	// all move properties
-	int from; // square the piece moved from
-	int to; // square the piece moved to
-	int piece; // piece that moved
-	int cPiece; // piece that was captured
-	bool enPassant; // if move was en passant
-	bool castling; // if move was castling
-	int promotion; // piece that was promoted to
-	int score; // score of move during move ordering
+	// bits 0-5: from square, bits 6-11: to square, bits 12-13: promotion piece type, bits 14-15: move flag
+	uint16_t data = 0;
+
+public:
+	Move() = default;
+	Move(int from, int to, int flag = NORMAL_MOVE, int promotionType = QUEEN)
+		: data((uint16_t)(from | (to << 6) | ((promotionType / 2 - 1) << 12) | (flag << 14)))
+	{
+	}
+
+	// move properties
+	int getFrom() const { return data & 0x3F; }
+	int getTo() const { return (data >> 6) & 0x3F; }
+	int getFlag() const { return data >> 14; }
+	int getPromotionType() const { return ((data >> 12) & 0x3) * 2 + 2; }
+	bool isPromotion() const { return getFlag() == PROMOTION_MOVE; }
+	bool isEnPassant() const { return getFlag() == EN_PASSANT_MOVE; }
+	bool isCastling() const { return getFlag() == CASTLING_MOVE; }
+
+	// raw 16 bit value for storing moves
+	uint16_t getData() const { return data; }
+	static Move fromData(uint16_t data);
 
 	// comparisons and notation
-	bool operator==(Move move);
+	bool operator==(Move move) const { return data == move.data; }
 	std::string getNotation();
 
 	// loading moves
-	static Move loadFromSquares(int from, int to, std::array<int, 64> piecesMB);
-	static Move loadFromNotation(std::string notation, std::array<int, 64> piecesMB);
+	static Move loadFromSquares(int from, int to, Board& board);
+	static Move loadFromNotation(std::string notation, Board& board);
 
 	// null moves
 	static Move nullmove();
 	static bool isNull(Move move);
-};
\ No newline at end of file
+};
+
+// fixed-capacity list of moves with their ordering scores, owned by the caller so that no move list touches the heap
+class MoveList
+{
+	// no chess position has more than 218 legal moves
+	std::array<Move, 256> moves;
+	std::array<int, 256> scores;
+	int count = 0;
+
+public:
+	// manage moves
+	void add(Move move) { moves[count++] = move; }
+	void resize(int newCount) { count = newCount; }
+	void clear() { count = 0; }
+	void swap(int first, int second) { std::swap(moves[first], moves[second]); std::swap(scores[first], scores[second]); }
+
+	// access methods
+	int size() { return count; }
+	Move& operator[](int index) { return moves[index]; }
+	int& score(int index) { return scores[index]; }
+	Move* begin() { return moves.data(); }
+	Move* end() { return moves.data() + count; }
+};
@@ -0,0 +1,147 @@
+#include "MovePicker.h"
+
+MovePicker::MovePicker(Board& boardPar, Evaluation& evaluationPar, std::optional<Move> ttMovePar, std::array<Move, 2> killersPar)
+	: board(boardPar), evaluation(evaluationPar), ttMove(ttMovePar.value_or(Move::nullmove())), killers(killersPar)
+{
+}
+
+// a capture is bad if an enemy pawn defends the target and the captured piece is worth less than the capturing piece
+bool MovePicker::isBadCapture(Move move, U64 pawnAttacks)
+{
+	return (pawnAttacks & (U64(1) << move.getTo())) && evaluation.getPieceValue(board.getCapturedPiece(move)) < evaluation.getPieceValue(board.getMovedPiece(move));
+}
+
+// a killer is tried before the quiets are generated if it's a legal quiet move in this position which hasn't been tried yet
+bool MovePicker::isPlayableKiller(Move killer)
+{
+	return !Move::isNull(killer) && !(killer == ttMove) && !killer.isPromotion() && board.getCapturedPiece(killer) == EMPTY && board.isLegal(killer);
+}
+
+// pick the move with the highest score which hasn't been tried yet (selection sort, so unused moves are never sorted)
+bool MovePicker::pickBest(MoveList& list, Move& move)
+{
+	while (index < list.size())
+	{
+		int best = index;
+		for (int i = index + 1; i < list.size(); i++)
+		{
+			if (list.score(i) > list.score(best))
+			{
+				best = i;
+			}
+		}
+
+		list.swap(index, best);
+		move = list[index];
+		index++;
+
+		// skip moves which have already been tried in an earlier stage
+		if (!(move == ttMove) && (stage != QUIETS_STAGE || (!(move == killers[0]) && !(move == killers[1]))))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// get the next move in the current stage, go through the stages until a move is found
+bool MovePicker::next(Move& move)
+{
+	switch (stage)
+	{
+	case TT_MOVE_STAGE:
+		stage = GENERATE_CAPTURES_STAGE;
+
+		// try the transposition table move before generating any moves
+		if (board.isLegal(ttMove))
+		{
+			move = ttMove;
+			return true;
+		}
+		[[fallthrough]];
+
+	case GENERATE_CAPTURES_STAGE:
+	{
+		board.generateMoves(moves, CAPTURES);
+		evaluation.scoreMoves(moves);
+
+		// put captures which probably lose material aside for the last stage
+		int color = board.getTurnColor();
+		U64 pawnAttacks = BB::pawnAnyAttacks(board.getPiecesBB()[PAWN + !color], !color);
+		int goodCount = 0;
+		for (int i = 0; i < moves.size(); i++)
+		{
+			if (isBadCapture(moves[i], pawnAttacks))
+			{
+				badCaptures.add(moves[i]);
+				badCaptures.score(badCaptures.size() - 1) = moves.score(i);
+			}
+			else
+			{
+				moves.swap(goodCount, i);
+				goodCount++;
+			}
+		}
+		moves.resize(goodCount);
+
+		index = 0;
+		stage = GOOD_CAPTURES_STAGE;
+		[[fallthrough]];
+	}
+
+	case GOOD_CAPTURES_STAGE:
+		if (pickBest(moves, move))
+		{
+			return true;
+		}
+		index = 0;
+		stage = KILLERS_STAGE;
+		[[fallthrough]];
+
+	case KILLERS_STAGE:
+		// killers are validated on the board, so they are tried without generating the quiet moves
+		while (index < 2)
+		{
+			Move killer = killers[index];
+			index++;
+
+			if (isPlayableKiller(killer))
+			{
+				move = killer;
+				return true;
+			}
+		}
+		stage = GENERATE_QUIETS_STAGE;
+		[[fallthrough]];
+
+	case GENERATE_QUIETS_STAGE:
+		board.generateMoves(moves, QUIETS);
+		evaluation.scoreMoves(moves);
+		index = 0;
+		stage = QUIETS_STAGE;
+		[[fallthrough]];
+
+	case QUIETS_STAGE:
+		if (pickBest(moves, move))
+		{
+			return true;
+		}
+		index = 0;
+		stage = BAD_CAPTURES_STAGE;
+		[[fallthrough]];
+
+	case BAD_CAPTURES_STAGE:
+		if (pickBest(badCaptures, move))
+		{
+			return true;
+		}
+		stage = FINISHED_STAGE;
+		[[fallthrough]];
+
+	case FINISHED_STAGE:
+		return false;
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include <optional>
+#include "Board.h"
+#include "Evaluation.h"
+
+// stages of the move picker, in the order they are passed through
+enum PickerStage
+{
+	TT_MOVE_STAGE,
+	GENERATE_CAPTURES_STAGE,
+	GOOD_CAPTURES_STAGE,
+	KILLERS_STAGE,
+	GENERATE_QUIETS_STAGE,
+	QUIETS_STAGE,
+	BAD_CAPTURES_STAGE,
+	FINISHED_STAGE
+};
+
+// class for picking moves one by one in the main search, moves are only generated when they are needed
+class MovePicker
+{
+	Board& board;
+	Evaluation& evaluation;
+
+	// moves which are tried before the generated moves of their stage
+	Move ttMove;
+	std::array<Move, 2> killers;
+
+	// generated moves (captures, later quiets) and captures which probably lose material
+	MoveList moves;
+	MoveList badCaptures;
+	int index = 0;
+
+	int stage = TT_MOVE_STAGE;
+
+	// helper functions
+	bool isBadCapture(Move move, U64 pawnAttacks);
+	bool isPlayableKiller(Move killer);
+	bool pickBest(MoveList& list, Move& move);
+
+public:
+	MovePicker(Board& boardPar, Evaluation& evaluationPar, std::optional<Move> ttMovePar, std::array<Move, 2> killersPar);
+
+	// get the next move, returns false if there are no moves left
+	bool next(Move& move);
+};
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <optional>
+#include <random>
 #include "Board.h"
 
 // class for a node in the game
@@ -0,0 +1,193 @@
+#include "Perft.h"
+#include <iostream>
+#include <thread>
+
+// allocate the hash table if a size is given and start the worker threads
+Perft::Perft(int hashMB, int threads)
+{
+	if (hashMB > 0)
+	{
+		table = std::vector<PerftEntry>((size_t)hashMB * 1024 * 1024 / sizeof(PerftEntry));
+	}
+
+	for (int i = 1; i < threads; i++)
+	{
+		workers.emplace_back(&Perft::workerLoop, this);
+	}
+}
+
+// end the worker threads
+Perft::~Perft()
+{
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		quitting = true;
+	}
+	startCondition.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+// number of threads working on a run, including the calling thread
+int Perft::getThreads()
+{
+	return (int)workers.size() + 1;
+}
+
+// look up the node count of a position at given depth
+bool Perft::probe(U64 key, int depth, U64& nodes)
+{
+	PerftEntry& entry = table[key % table.size()];
+	U64 data = entry.data.load(std::memory_order_relaxed);
+	U64 check = entry.check.load(std::memory_order_relaxed);
+
+	if ((check ^ data) == key && (int)(data & 0xFF) == depth)
+	{
+		nodes = data >> 8;
+		return true;
+	}
+
+	return false;
+}
+
+// save the node count of a position at given depth, always replaces the old entry
+void Perft::store(U64 key, int depth, U64 nodes)
+{
+	PerftEntry& entry = table[key % table.size()];
+	U64 data = (nodes << 8) | (U64)depth;
+
+	entry.data.store(data, std::memory_order_relaxed);
+	entry.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+// count leaf nodes recursively
+U64 Perft::count(Board& board, int depth)
+{
+	// the hash table is probed first so hits don't need a move generation
+	U64 key = board.getZobristKey();
+	U64 nodes = 0;
+	if (depth > 1 && !table.empty() && probe(key, depth, nodes))
+	{
+		return nodes;
+	}
+
+	MoveList moveList;
+	board.generateMoves(moveList);
+
+	// bulk counting: the number of legal moves is the number of leaf nodes
+	if (depth == 1)
+	{
+		return moveList.size();
+	}
+
+	for (Move move : moveList)
+	{
+		board.makeMove(move);
+		nodes += count(board, depth - 1);
+		board.unmakeMove(move);
+	}
+
+	if (!table.empty())
+	{
+		store(key, depth, nodes);
+	}
+
+	return nodes;
+}
+
+// workers sleep until a new run is started and take part in it
+void Perft::workerLoop()
+{
+	std::vector<StateInfo> threadStates;
+	int lastRun = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(poolMutex);
+			startCondition.wait(lock, [&]() { return quitting || runCount != lastRun; });
+			if (quitting)
+			{
+				return;
+			}
+			lastRun = runCount;
+		}
+
+		work(threadStates);
+
+		{
+			std::lock_guard<std::mutex> lock(poolMutex);
+			busyWorkers--;
+		}
+		doneCondition.notify_one();
+	}
+}
+
+// every thread works on its own copy of the board and takes the next unsearched root move
+void Perft::work(std::vector<StateInfo>& threadStates)
+{
+	Board threadBoard = rootBoard;
+	threadBoard.setStateStack(threadStates);
+
+	for (int i = nextMove++; i < rootMoves.size(); i = nextMove++)
+	{
+		if (rootDepth == 1)
+		{
+			rootNodes[i] = 1;
+			continue;
+		}
+
+		threadBoard.makeMove(rootMoves[i]);
+		rootNodes[i] = count(threadBoard, rootDepth - 1);
+		threadBoard.unmakeMove(rootMoves[i]);
+	}
+}
+
+// count leaf nodes, root moves are split across the worker threads and the calling thread
+U64 Perft::run(const Board& board, int depth, bool divide)
+{
+	if (depth <= 0)
+	{
+		return 1;
+	}
+
+	// set up the run before waking up the workers
+	rootBoard = board;
+	rootDepth = depth;
+	rootMoves.clear();
+	rootBoard.generateMoves(rootMoves);
+	rootNodes.assign(rootMoves.size(), 0);
+	nextMove = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		busyWorkers = (int)workers.size();
+		runCount++;
+	}
+	startCondition.notify_all();
+
+	work(states);
+
+	// wait until every worker has finished its root moves
+	{
+		std::unique_lock<std::mutex> lock(poolMutex);
+		doneCondition.wait(lock, [&]() { return busyWorkers == 0; });
+	}
+
+	// sum up the nodes and print out the number of nodes after each move in generation order
+	U64 nodes = 0;
+	for (int i = 0; i < rootMoves.size(); i++)
+	{
+		if (divide)
+		{
+			std::cout << rootMoves[i].getNotation() << ": " << rootNodes[i] << "\n";
+		}
+
+		nodes += rootNodes[i];
+	}
+
+	return nodes;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Board.h"
+
+// entry of the perft hash table, the check word is the key xor'd with the data so torn entries from other threads are rejected
+struct PerftEntry
+{
+	std::atomic<U64> check;
+	std::atomic<U64> data; // node count in the upper 56 bits, depth in the lower 8 bits
+};
+
+// class for counting the leaf nodes of the legal move tree (performance test), bypasses evaluation updates
+class Perft
+{
+	// optional hash table for subtree node counts, keyed by zobrist key and depth
+	std::vector<PerftEntry> table;
+
+	// hash table helper functions
+	bool probe(U64 key, int depth, U64& nodes);
+	void store(U64 key, int depth, U64 nodes);
+
+	// count the leaf nodes below a position, leaf nodes are counted in bulk at depth 1
+	U64 count(Board& board, int depth);
+
+	// worker threads which stay alive for all runs, the thread calling run works as well
+	std::vector<std::thread> workers;
+	std::mutex poolMutex;
+	std::condition_variable startCondition;
+	std::condition_variable doneCondition;
+	int runCount = 0;
+	int busyWorkers = 0;
+	bool quitting = false;
+
+	// current run, root moves are split across the threads
+	Board rootBoard;
+	int rootDepth = 0;
+	MoveList rootMoves;
+	std::vector<U64> rootNodes;
+	std::atomic<int> nextMove = 0;
+	std::vector<StateInfo> states;
+
+	// wait for runs and work on them
+	void workerLoop();
+	void work(std::vector<StateInfo>& threadStates);
+
+public:
+	Perft(int hashMB = 0, int threads = 1);
+	~Perft();
+
+	// count the leaf nodes below a position with all threads
+	U64 run(const Board& board, int depth, bool divide = false);
+
+	int getThreads();
+};
\ No newline at end of file
@@ -1,41 +1,31 @@
 #include "Piece.h"
+#include <stdexcept>
 
-// map for converting ids to chars
-std::map<int, char> Piece::IDchars = {
-	{ KING + BLACK, 'k' },
-	{ QUEEN + BLACK, 'q' },
-	{ BISHOP + BLACK, 'b' },
-	{ KNIGHT + BLACK, 'n' },
-	{ ROOK + BLACK, 'r' },
-	{ PAWN + BLACK, 'p' },
-	{ KING + WHITE, 'K' },
-	{ QUEEN + WHITE, 'Q' },
-	{ BISHOP + WHITE, 'B' },
-	{ KNIGHT + WHITE, 'N' },
-	{ ROOK + WHITE, 'R' },
-	{ PAWN + WHITE, 'P' }
-};
-
-// map for converting chars to ids
-std::map<char, int> Piece::charIDs = {
-	{ 'k', KING + BLACK },
-	{ 'q', QUEEN + BLACK },
-	{ 'b', BISHOP + BLACK },
-	{ 'n', KNIGHT + BLACK },
-	{ 'r', ROOK + BLACK },
-	{ 'p', PAWN + BLACK },
-	{ 'K', KING + WHITE },
-	{ 'Q', QUEEN + WHITE },
-	{ 'B', BISHOP + WHITE },
-	{ 'N', KNIGHT + WHITE },
-	{ 'R', ROOK + WHITE },
-	{ 'P', PAWN + WHITE }
-};
+// table for converting ids to chars
+constexpr std::array<char, 12> Piece::IDchars = { 'K', 'k', 'Q', 'q', 'B', 'b', 'N', 'n', 'R', 'r', 'P', 'p' };
+
+// table for converting chars to ids, generated from the inverse table
+constexpr std::array<int, 128> Piece::charIDs = []()
+{
+	std::array<int, 128> ids = {};
+	ids.fill(EMPTY);
+	for (int i = 0; i < 12; i++)
+	{
+		ids[IDchars[i]] = i;
+	}
+
+	return ids;
+}();
 
 // conversion between piece chars and ids
 int Piece::charToInt(char c)
 {
-	return charIDs.at(c);
+	if (c < 0 || charIDs[c] == EMPTY)
+	{
+		throw std::out_of_range("Invalid piece char");
+	}
+
+	return charIDs[c];
 }
 
 char Piece::intToChar(int n)
@@ -1,5 +1,5 @@
 #pragma once
-#include <map>
+#include <array>
 
 // IDs for all pieces
 enum Piece_IDs
@@ -17,10 +17,9 @@ enum Piece_IDs
 
 // class for functions regarding pieces
 class Piece {
-	// maps for pieces
-	static std::map<char, int> charIDs;
-	static std::map<int, char> IDchars;
-	static std::map<int, int> pieceToValue;
+	// tables for converting between piece chars and ids
+	static const std::array<int, 128> charIDs;
+	static const std::array<char, 12> IDchars;
 
 public:
 	static int charToInt(char c);
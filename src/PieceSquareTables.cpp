@@ -1,9 +1,8 @@
 #include "PieceSquareTables.h"
 
-// initialize piece square tables according to https ://www.chessprogramming.org/Simplified_Evaluation_Function
-PieceSquareTables::PieceSquareTables()
-{
-	tables[KING] =
+// piece square tables according to https ://www.chessprogramming.org/Simplified_Evaluation_Function
+constexpr std::array<std::array<int, 64>, 6> PieceSquareTables::tables = { {
+	// king
 	{
 		-30,-40,-40,-50,-50,-40,-40,-30,
 		-30,-40,-40,-50,-50,-40,-40,-30,
@@ -13,9 +12,9 @@ PieceSquareTables::PieceSquareTables()
 		-10,-20,-20,-20,-20,-20,-20,-10,
 		 20, 20,  0,  0,  0,  0, 20, 20,
 		 20, 30, 10,  0,  0, 10, 30, 20
-	};
+	},
 
-	tables[QUEEN] =
+	// queen
 	{
 		-20,-10,-10, -5, -5,-10,-10,-20,
 		-10,  0,  0,  0,  0,  0,  0,-10,
@@ -25,21 +24,9 @@ PieceSquareTables::PieceSquareTables()
 		-10,  5,  5,  5,  5,  5,  0,-10,
 		-10,  0,  5,  0,  0,  0,  0,-10,
 		-20,-10,-10, -5, -5,-10,-10,-20
-	};
-
-	tables[ROOK] =
-	{
-		0,  0,  0,  0,  0,  0,  0,  0,
-		5, 10, 10, 10, 10, 10, 10,  5,
-	   -5,  0,  0,  0,  0,  0,  0, -5,
-	   -5,  0,  0,  0,  0,  0,  0, -5,
-	   -5,  0,  0,  0,  0,  0,  0, -5,
-	   -5,  0,  0,  0,  0,  0,  0, -5,
-	   -5,  0,  0,  0,  0,  0,  0, -5,
-		0,  0,  0,  5,  5,  0,  0,  0
-	};
+	},
 
-	tables[BISHOP] =
+	// bishop
 	{
 		-20,-10,-10,-10,-10,-10,-10,-20,
 		-10,  0,  0,  0,  0,  0,  0,-10,
@@ -49,9 +36,9 @@ PieceSquareTables::PieceSquareTables()
 		-10, 10, 10, 10, 10, 10, 10,-10,
 		-10,  5,  0,  0,  0,  0,  5,-10,
 		-20,-10,-10,-10,-10,-10,-10,-20,
-	};
+	},
 
-	tables[KNIGHT] =
+	// knight
 	{
 		-50,-40,-30,-30,-30,-30,-40,-50,
 		-40,-20,  0,  0,  0,  0,-20,-40,
@@ -61,9 +48,21 @@ PieceSquareTables::PieceSquareTables()
 		-30,  5, 10, 15, 15, 10,  5,-30,
 		-40,-20,  0,  5,  5,  0,-20,-40,
 		-50,-40,-30,-30,-30,-30,-40,-50,
-	};
+	},
 
-	tables[PAWN] =
+	// rook
+	{
+		 0,  0,  0,  0,  0,  0,  0,  0,
+		 5, 10, 10, 10, 10, 10, 10,  5,
+		-5,  0,  0,  0,  0,  0,  0, -5,
+		-5,  0,  0,  0,  0,  0,  0, -5,
+		-5,  0,  0,  0,  0,  0,  0, -5,
+		-5,  0,  0,  0,  0,  0,  0, -5,
+		-5,  0,  0,  0,  0,  0,  0, -5,
+		 0,  0,  0,  5,  5,  0,  0,  0
+	},
+
+	// pawn
 	{
 		 0,  0,  0,  0,  0,  0,  0,  0,
 		50, 50, 50, 50, 50, 50, 50, 50,
@@ -73,20 +72,21 @@ PieceSquareTables::PieceSquareTables()
 		 5, -5,-10,  0,  0,-10, -5,  5,
 		 5, 10, 10,-20,-20, 10, 10,  5,
 		 0,  0,  0,  0,  0,  0,  0,  0
-	};
+	}
+} };
 
-	kingEnd =
-	{
-		-50,-40,-30,-20,-20,-30,-40,-50,
-		-30,-20,-10,  0,  0,-10,-20,-30,
-		-30,-10, 20, 30, 30, 20,-10,-30,
-		-30,-10, 30, 40, 40, 30,-10,-30,
-		-30,-10, 30, 40, 40, 30,-10,-30,
-		-30,-10, 20, 30, 30, 20,-10,-30,
-		-30,-30,  0,  0,  0,  0,-30,-30,
-		-50,-30,-30,-30,-30,-30,-30,-50
-	};
-}
+// piece square table for king in endgame
+constexpr std::array<int, 64> PieceSquareTables::kingEnd =
+{
+	-50,-40,-30,-20,-20,-30,-40,-50,
+	-30,-20,-10,  0,  0,-10,-20,-30,
+	-30,-10, 20, 30, 30, 20,-10,-30,
+	-30,-10, 30, 40, 40, 30,-10,-30,
+	-30,-10, 30, 40, 40, 30,-10,-30,
+	-30,-10, 20, 30, 30, 20,-10,-30,
+	-30,-30,  0,  0,  0,  0,-30,-30,
+	-50,-30,-30,-30,-30,-30,-30,-50
+};
 
 // get the score of a piece on a square
 int PieceSquareTables::getScore(int piece, int square, double endgameWeight)
@@ -97,11 +97,11 @@ int PieceSquareTables::getScore(int piece, int square, double endgameWeight)
 	if (pieceType == KING)
 	{
 		// if it's a king, combine endgame and midgame score
-		return (int)((tables[pieceType][Square::perspective(square, pieceColor)] * (1 - endgameWeight) + kingEnd[Square::perspective(square, pieceColor)] * endgameWeight) * 1.79);
+		return (int)((tables[pieceType / 2][Square::perspective(square, pieceColor)] * (1 - endgameWeight) + kingEnd[Square::perspective(square, pieceColor)] * endgameWeight) * 1.79);
 	}
 	else
 	{
-		// if it's not a king, return score in the map
-		return (int)(tables[pieceType][Square::perspective(square, pieceColor)] * 1.79);
+		// if it's not a king, return score in the table
+		return (int)(tables[pieceType / 2][Square::perspective(square, pieceColor)] * 1.79);
 	}
 }
\ No newline at end of file
@@ -6,12 +6,12 @@
 // class for managing piece square tables
 class PieceSquareTables
 {
-	std::map<int, std::array<int, 64>> tables;
+	// piece square tables indexed by piece type / 2
+	static const std::array<std::array<int, 64>, 6> tables;
 
 	// piece square table for king in endgame
-	std::array<int, 64> kingEnd;
+	static const std::array<int, 64> kingEnd;
 
 public:
-	PieceSquareTables();
 	int getScore(int piece, int square, double endgameWeight);
 };
\ No newline at end of file
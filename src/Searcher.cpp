@@ -0,0 +1,414 @@
+#include "Searcher.h"
+
+int Searcher::reductionBase = 75;
+int Searcher::reductionDivisor = 225;
+std::array<std::array<int, 64>, 64> Searcher::reductions;
+
+// initialize the reduction table at program start (after the parameters above have been set)
+static bool reductionsInitialized = Searcher::initReductions();
+
+// every search thread gets its own board, state stack and evaluation
+Searcher::Searcher(const Board& boardPar, TranspositionTable& ttPar, SearchControl& controlPar, bool mainThreadPar) : board(boardPar), tt(ttPar), evaluation(board, tt), control(controlPar), mainThread(mainThreadPar)
+{
+	board.setStateStack(states);
+	evaluation.reloadEval();
+
+	for (std::array<Move, 2>& killers : killerMoves)
+	{
+		killers = { Move::nullmove(), Move::nullmove() };
+	}
+}
+
+// calculate late move reductions for every depth and move number from the parameters
+bool Searcher::initReductions()
+{
+	for (int depth = 0; depth < 64; depth++)
+	{
+		for (int moveNumber = 0; moveNumber < 64; moveNumber++)
+		{
+			double reduction = reductionBase / 100.0 + std::log(std::max(depth, 1)) * std::log(std::max(moveNumber, 1)) / (reductionDivisor / 100.0);
+			reductions[depth][moveNumber] = (depth == 0 || moveNumber == 0) ? 0 : (int)reduction;
+		}
+	}
+
+	return true;
+}
+
+// change the parameters of the reduction table for tuning
+void Searcher::setReductionBase(int base)
+{
+	reductionBase = base;
+	initReductions();
+}
+
+void Searcher::setReductionDivisor(int divisor)
+{
+	reductionDivisor = std::max(divisor, 1);
+	initReductions();
+}
+
+// actions when new move is played/unplayed
+void Searcher::makeMove(Move move)
+{
+	evaluation.makeMove(move);
+	board.makeMove(move);
+}
+
+void Searcher::unmakeMove(Move move)
+{
+	board.unmakeMove(move);
+	evaluation.unmakeMove();
+}
+
+// check whether the search has to be stopped, the main thread stops all threads once the time limit is reached
+bool Searcher::shouldStop()
+{
+	if (mainThread && !control.pondering.load(std::memory_order_relaxed))
+	{
+		std::chrono::duration<double> diff = std::chrono::system_clock::now() - control.start;
+		if (diff.count() >= control.timeLimit)
+		{
+			control.stop.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	return control.stop.load(std::memory_order_relaxed);
+}
+
+// search the root position to a depth, deeper searches start with a window around the eval of the previous depth (aspiration window)
+bool Searcher::searchDepth(int depth)
+{
+	int previousEval = bestEval;
+	int window = aspirationWindow;
+	int alpha = LOWEST_SCORE;
+	int beta = HIGHEST_SCORE;
+
+	if (depth >= aspirationDepth && completedDepth > 0 && !Score::isMateScore(previousEval))
+	{
+		alpha = previousEval - window;
+		beta = previousEval + window;
+	}
+
+	while (true)
+	{
+		int eval = search(alpha, beta, depth, 0, false);
+		if (control.stop.load(std::memory_order_relaxed))
+		{
+			return false;
+		}
+
+		// widen the window on the side the search failed, very wide windows are opened completely
+		if (eval <= alpha && alpha != LOWEST_SCORE)
+		{
+			window *= 4;
+			alpha = (window > maxAspirationWindow) ? LOWEST_SCORE : previousEval - window;
+		}
+		else if (eval >= beta && beta != HIGHEST_SCORE)
+		{
+			window *= 4;
+			beta = (window > maxAspirationWindow) ? HIGHEST_SCORE : previousEval + window;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	completedDepth = depth;
+	completedMove = bestMove;
+	completedEval = bestEval;
+	completedPv = getPrincipalVariation(depth);
+	return true;
+}
+
+// helper threads go through the depths on their own, threads starting at different depths spread out over the tree
+void Searcher::iterate(int startDepth, int lastDepth)
+{
+	for (int depth = startDepth; depth <= lastDepth && searchDepth(depth); depth++);
+}
+
+// return principal variation as moves
+std::vector<Move> Searcher::getPrincipalVariation(int depth)
+{
+	// iterate through moves in the transposition table while saving moves made
+	std::optional<Move> move = tt.getStoredMove(board.getZobristKey(), true);
+	std::vector<Move> pv;
+
+	MoveList moves;
+	board.generateMoves(moves);
+
+	for (int i = 0; i < depth && move.has_value() && board.isLegal(*move) && board.getState(moves) == PLAY; i++)
+	{
+		pv.push_back(*move);
+		makeMove(*move);
+		board.generateMoves(moves);
+		move = tt.getStoredMove(board.getZobristKey(), true);
+	}
+
+	// undo changes
+	for (int i = (int)pv.size() - 1; i >= 0; i--)
+	{
+		unmakeMove(pv[i]);
+	}
+
+	return pv;
+}
+
+// minimax search of the game tree
+int Searcher::search(int alpha, int beta, int depth, int plyFromRoot, bool nullMove)
+{
+	// if the time limit has been reached, abort search and return
+	if (shouldStop())
+	{
+		return alpha;
+	}
+
+	nodes.store(nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	 
+	// mark a two-fold repetition as a draw (not completely correct)
+	if (board.checkRepetition() && plyFromRoot > 1)
+	{
+		return DRAW_SCORE;
+	}
+
+	// check for trivial draws before generating moves
+	if (board.checkDraw())
+	{
+		return DRAW_SCORE;
+	}
+
+	// if a position in the search tree can be repeated, at least a draw can be reached
+	if (alpha < DRAW_SCORE && board.hasUpcomingRepetition(plyFromRoot))
+	{
+		alpha = DRAW_SCORE;
+		if (alpha >= beta)
+		{
+			return beta;
+		}
+	}
+
+	// get the stored eval in the transposition table
+	std::optional<int> ttEval = tt.getStoredEval(board.getZobristKey(), depth, plyFromRoot, alpha, beta);
+	if (ttEval.has_value())
+	{
+		if (plyFromRoot != 0)
+		{
+			return *ttEval;
+		}
+
+		// the root only takes the stored eval with a legal best move (the entry could be from a zobrist key collision)
+		std::optional<Move> ttMove = tt.getStoredMove(board.getZobristKey(), true);
+		if (ttMove.has_value() && board.isLegal(*ttMove))
+		{
+			bestMove = *ttMove;
+			bestEval = *ttEval;
+			return *ttEval;
+		}
+	}
+
+	// evaluate board with quiescence search if depth limit is reached
+	if (depth == 0)
+	{
+		return quiescenceSearch(alpha, beta, plyFromRoot, true);
+	}
+
+	bool inCheck = board.inCheck();
+
+	// evaluate null move for null move pruning
+	if (!inCheck && !nullMove && depth > 3)
+	{
+		makeMove(Move::nullmove());
+		int nullEval = -search(-beta, -alpha, depth - 4, plyFromRoot + 1, true);
+		unmakeMove(Move::nullmove());
+
+		if (nullEval >= beta)
+		{
+			return beta;
+		}
+	}
+
+	// moves are generated lazily by the move picker, starting with the transposition table move
+	std::array<Move, 2> killers = { Move::nullmove(), Move::nullmove() };
+	if (plyFromRoot < (int)killerMoves.size())
+	{
+		killers = killerMoves[plyFromRoot];
+	}
+	MovePicker movePicker(board, evaluation, tt.getStoredMove(board.getZobristKey(), false), killers);
+
+	Move bestPositionMove = Move::nullmove();
+	int nodeType = UPPER_BOUND_NODE;
+	int moveCount = 0;
+
+	// loop through all legal moves
+	Move move;
+	while (movePicker.next(move))
+	{
+		moveCount++;
+
+		bool quiet = board.getCapturedPiece(move) == EMPTY && !move.isPromotion();
+
+		// get score of given move, the first move is searched with the full window (principal variation search)
+		makeMove(move);
+		int eval;
+		if (moveCount == 1)
+		{
+			eval = -search(-beta, -alpha, depth - 1, plyFromRoot + 1, nullMove);
+		}
+		else
+		{
+			// late quiet moves are unlikely to be good, so they are searched with less depth (late move reductions)
+			int reduction = 0;
+			if (depth >= reductionMinDepth && moveCount > reductionMinMoves && quiet && !inCheck && !board.inCheck())
+			{
+				reduction = std::min(reductions[std::min(depth, 63)][std::min(moveCount, 63)], depth - 2);
+			}
+
+			// later moves are expected to be worse, so a null window only checks whether they beat alpha
+			eval = -search(-alpha - 1, -alpha, depth - 1 - reduction, plyFromRoot + 1, nullMove);
+
+			// reduced moves which beat alpha are checked again with the full depth
+			if (reduction > 0 && eval > alpha)
+			{
+				eval = -search(-alpha - 1, -alpha, depth - 1, plyFromRoot + 1, nullMove);
+			}
+
+			// if they do, search them again with the full window to get their exact score
+			if (eval > alpha && eval < beta)
+			{
+				eval = -search(-beta, -alpha, depth - 1, plyFromRoot + 1, nullMove);
+			}
+		}
+		unmakeMove(move);
+
+		// the score of a stopped search is meaningless, it mustn't become the best move or be stored
+		if (control.stop.load(std::memory_order_relaxed))
+		{
+			return alpha;
+		}
+
+		// beta-cutoff (move is too good to be allowed by the opponent)
+		if (eval >= beta)
+		{
+			// save quiet moves as killer moves of this ply
+			if (board.getCapturedPiece(move) == EMPTY && !move.isPromotion() && plyFromRoot < (int)killerMoves.size() && !(move == killerMoves[plyFromRoot][0]))
+			{
+				killerMoves[plyFromRoot][1] = killerMoves[plyFromRoot][0];
+				killerMoves[plyFromRoot][0] = move;
+			}
+
+			// a fail-high at the root (outside of the aspiration window) still gives the new best move
+			if (plyFromRoot == 0)
+			{
+				bestMove = move;
+				bestEval = beta;
+			}
+
+			tt.storeEntry(board.getZobristKey(), beta, depth, move, LOWER_BOUND_NODE, plyFromRoot);
+			return beta;
+		}
+
+		// new best move for the position is found
+		if (eval > alpha)
+		{
+			alpha = eval;
+			bestPositionMove = move;
+			nodeType = EXACT_NODE;
+			
+			// save move as best move if it's the main search function
+			if (plyFromRoot == 0)
+			{
+				bestMove = move;
+				bestEval = eval;
+			}
+		}
+	}
+
+	// if there are no legal moves, it's checkmate or stalemate
+	if (moveCount == 0)
+	{
+		return inCheck ? Score::getNegativeMate(plyFromRoot) : DRAW_SCORE;
+	}
+
+	tt.storeEntry(board.getZobristKey(), alpha, depth, bestPositionMove, nodeType, plyFromRoot);
+	return alpha;
+}
+
+// evaluate all non-quiet/messy positions, quiet checks are only searched on the first ply
+int Searcher::quiescenceSearch(int alpha, int beta, int plyFromRoot, bool searchChecks)
+{
+	// if the time limit has been reached, abort search and return
+	if (shouldStop())
+	{
+		return alpha;
+	}
+
+	nodes.store(nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+	// check for trivial draws
+	if (board.checkDraw())
+	{
+		return DRAW_SCORE;
+	}
+
+	// when in check, doing nothing isn't an option, so all moves are searched instead of only captures
+	bool inCheck = board.inCheck();
+
+	if (!inCheck)
+	{
+		int eval = evaluation.evaluate();
+
+		// static eval is used as a lower-bound of the score, assuming there is a better move than doing nothing (null move observation)
+		if (eval >= beta)
+		{
+			return beta;
+		}
+		if (eval > alpha)
+		{
+			alpha = eval;
+		}
+	}
+
+	MoveList moves;
+	board.generateMoves(moves, inCheck ? EVASIONS : CAPTURES);
+	evaluation.orderMoves(moves);
+
+	// quiet checks are tried after the captures
+	if (!inCheck && searchChecks)
+	{
+		MoveList checks;
+		board.generateMoves(checks, QUIET_CHECKS);
+		for (Move move : checks)
+		{
+			moves.add(move);
+		}
+	}
+
+	// checkmate if there are no moves out of check
+	if (inCheck && moves.size() == 0)
+	{
+		return std::max(alpha, std::min(beta, Score::getNegativeMate(plyFromRoot)));
+	}
+
+	// loop through all legal captures and quiet checks (or all evasions when in check)
+	for (const Move& move : moves)
+	{
+		// get score of given move
+		makeMove(move);
+		int eval = -quiescenceSearch(-beta, -alpha, plyFromRoot + 1, false);
+		unmakeMove(move);
+
+		// beta-cutoff (move is too good to be allowed by the opponent)
+		if (eval >= beta)
+		{
+			return beta;
+		}
+
+		// new best move for the position is found
+		if (eval > alpha)
+		{
+			alpha = eval;
+		}
+	}
+
+	return alpha;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include "Board.h"
+#include "TranspositionTable.h"
+#include "Evaluation.h"
+#include "MovePicker.h"
+
+// time limit and stop flag of a search, shared by all search threads
+struct SearchControl
+{
+	std::chrono::time_point<std::chrono::system_clock> start;
+	double timeLimit = 0;
+	std::atomic<bool> stop = false;
+
+	// the time limit only applies after a ponderhit, time spent pondering counts towards it
+	std::atomic<bool> pondering = false;
+};
+
+// class for a single search thread, every thread searches its own copy of the board and they only share the transposition table (lazy SMP)
+class Searcher
+{
+	Board board;
+	std::vector<StateInfo> states;
+	TranspositionTable& tt;
+	Evaluation evaluation;
+
+	SearchControl& control;
+	bool mainThread;
+
+	// half width of the first aspiration window, the depth from which it is used and the width above which the window is opened completely
+	static constexpr int aspirationWindow = 25;
+	static constexpr int aspirationDepth = 4;
+	static constexpr int maxAspirationWindow = 1000;
+
+	// late move reductions by depth and move number: base + log(depth) * log(move number) / divisor (parameters in hundredths)
+	static int reductionBase;
+	static int reductionDivisor;
+	static std::array<std::array<int, 64>, 64> reductions;
+
+	// quiet moves are only reduced from this depth on and after this many moves
+	static constexpr int reductionMinDepth = 3;
+	static constexpr int reductionMinMoves = 3;
+
+	// quiet moves which caused beta-cutoffs at every ply
+	std::array<std::array<Move, 2>, 128> killerMoves;
+
+	Move bestMove = Move::nullmove();
+	int bestEval = LOWEST_SCORE;
+
+	// result of the deepest completed search, unfinished depths can change the move, eval and transposition table pv afterwards
+	int completedDepth = 0;
+	Move completedMove = Move::nullmove();
+	int completedEval = LOWEST_SCORE;
+	std::vector<Move> completedPv;
+
+	// read by the main thread while the search is running
+	std::atomic<long long> nodes = 0;
+
+	// only the main thread checks the clock, the other threads wait for the stop flag
+	bool shouldStop();
+
+	int search(int alpha, int beta, int depth, int plyFromRoot, bool nullMove);
+	int quiescenceSearch(int alpha, int beta, int plyFromRoot, bool searchChecks);
+
+	void makeMove(Move move);
+	void unmakeMove(Move move);
+
+	std::vector<Move> getPrincipalVariation(int depth);
+
+public:
+	// deepest depth a search can reach (killer moves are stored up to this ply)
+	static constexpr int maxDepth = 127;
+
+	// fill the reduction table, called at program start and after the parameters are changed
+	static bool initReductions();
+	static void setReductionBase(int base);
+	static void setReductionDivisor(int divisor);
+
+	Searcher(const Board& boardPar, TranspositionTable& ttPar, SearchControl& controlPar, bool mainThreadPar);
+
+	// search the root position to a depth, returns false if the search has been stopped
+	bool searchDepth(int depth);
+
+	// search with increasing depths until the last depth is completed or the search is stopped
+	void iterate(int startDepth, int lastDepth);
+
+	Move getBestMove() { return bestMove; }
+	int getCompletedDepth() { return completedDepth; }
+	Move getCompletedMove() { return completedMove; }
+	int getCompletedEval() { return completedEval; }
+	const std::vector<Move>& getCompletedPv() { return completedPv; }
+	long long getNodes() { return nodes.load(std::memory_order_relaxed); }
+};
\ No newline at end of file
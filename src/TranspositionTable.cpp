@@ -1,7 +1,7 @@
 #include "TranspositionTable.h"
 
-// create the entries array and initialize board variable
-TranspositionTable::TranspositionTable(Board& boardPar) : board(boardPar), entries(std::vector<Entry>(size))
+// create the entries array
+TranspositionTable::TranspositionTable() : entries(std::vector<Entry>(size))
 {
 	clear();
 }
@@ -11,7 +11,8 @@ void TranspositionTable::clear()
 {
 	for (int i = 0; i < size; i++)
 	{
-		entries[i].valid = false;
+		entries[i].data.store(U64(0), std::memory_order_relaxed);
+		entries[i].check.store(U64(0), std::memory_order_relaxed);
 	}
 }
 
@@ -21,68 +22,71 @@ void TranspositionTable::setSizeMB(int sizeMB)
 	// calculate entry count based on 16 bytes per entry
 	size = sizeMB * 1000000 / 16;
 
-	// resize entries vector
-	entries.resize(size);
-	entries.shrink_to_fit();
+	// recreate entries vector (atomic entries can't be moved by a resize)
+	entries = std::vector<Entry>(size);
 	clear();
 }
 
-// store empty in transposition
-void TranspositionTable::storeEntry(int eval, int depth, Move move, int nodeType, int numPly)
+// unpack the entry of a position, entries of other positions or torn entries are returned as invalid
+EntryData TranspositionTable::load(U64 key)
+{
+	Entry& entry = entries[getIndex(key)];
+	U64 data = entry.data.load(std::memory_order_relaxed);
+	U64 check = entry.check.load(std::memory_order_relaxed);
+
+	EntryData entryData = { (int)(uint32_t)data, (int)((data >> 32) & 0xFF), Move::fromData((uint16_t)(data >> 40)), (int)((data >> 56) & 0x3), (bool)((data >> 58) & 1) };
+	entryData.valid = entryData.valid && (check ^ data) == key;
+	return entryData;
+}
+
+// pack and save the entry of a position
+void TranspositionTable::save(U64 key, EntryData entryData)
+{
+	Entry& entry = entries[getIndex(key)];
+	U64 data = (U64)(uint32_t)entryData.eval | ((U64)entryData.depth << 32) | ((U64)entryData.move.getData() << 40) | ((U64)entryData.nodeType << 56) | ((U64)entryData.valid << 58);
+
+	entry.data.store(data, std::memory_order_relaxed);
+	entry.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+// store entry in transposition table
+void TranspositionTable::storeEntry(U64 key, int eval, int depth, Move move, int nodeType, int numPly)
 {
 	// only overwrite exact node if the new node is also exact
-	Entry oldEntry = entries[getIndex()];
-	if (oldEntry.valid && oldEntry.nodeType == EXACT_NODE && nodeType != EXACT_NODE)
+	U64 oldData = entries[getIndex(key)].data.load(std::memory_order_relaxed);
+	if (((oldData >> 58) & 1) && (int)((oldData >> 56) & 0x3) == EXACT_NODE && nodeType != EXACT_NODE)
 	{
 		return;
 	}
 
 	// create entry with corrected eval
-	Entry entry = { board.getZobristKey(), Score::makeMateCorrection(eval, numPly), (unsigned int)std::min(depth, 255), (unsigned int)move.from, (unsigned int)move.to, (unsigned int)(move.promotion + 1), (unsigned int)nodeType, (unsigned int)true };
-
-	// mark move as null by setting promotion to 15 (an unused value)
-	if (Move::isNull(move))
-	{
-		entry.promotion = 15;
-	}
-
-	// store entry in array
-	entries[getIndex()] = entry;
+	save(key, { Score::makeMateCorrection(eval, numPly), std::min(depth, 255), move, nodeType, true });
 }
 
-// get the stored move at this board position, parameter exact for whether node should be PV-node
-std::optional<Move> TranspositionTable::getStoredMove(Board& board, bool exact)
+// get the stored move of a position, parameter exact for whether node should be PV-node
+std::optional<Move> TranspositionTable::getStoredMove(U64 key, bool exact)
 {
-	// check if entry key is the board zobrist key
-	Entry entry = entries[getIndex()]; 
-	if (entry.key == board.getZobristKey() && entry.valid && (!exact || entry.nodeType == EXACT_NODE))
+	// check if entry belongs to the position
+	EntryData entry = load(key);
+	if (entry.valid && (!exact || entry.nodeType == EXACT_NODE))
 	{
 		// if yes -> return the move
-		Move move = Move::loadFromSquares(entry.from, entry.to, board.getPiecesMB());
-		move.promotion = (int)entry.promotion - 1;
-
-		// null moves are stored with 15 as promotion (an unused value)
-		if (entry.promotion == 15)
-		{
-			move = Move::nullmove();
-		}
-
-		return move;
+		return entry.move;
 	}
 
 	// if no -> return nothing
 	return std::optional<Move>();
 }
 
-// get the stored eval at this board position 
-std::optional<int> TranspositionTable::getStoredEval(int depth, int numPly, int alpha, int beta)
+// get the stored eval of a position
+std::optional<int> TranspositionTable::getStoredEval(U64 key, int depth, int numPly, int alpha, int beta)
 {
-	// check if entry key is the board zobrist key
-	Entry entry = entries[getIndex()];
-	if (entry.key == board.getZobristKey() && entry.valid)
+	// check if entry belongs to the position
+	EntryData entry = load(key);
+	if (entry.valid)
 	{
 		// check if the position has been searched to a greater or equal depth than required
-		if (entry.depth >= (unsigned int)depth)
+		if (entry.depth >= depth)
 		{
 			// correct eval for mates
 			int correctedEval = Score::makeMateCorrection(entry.eval, -numPly);
@@ -113,7 +117,7 @@ std::optional<int> TranspositionTable::getStoredEval(int depth, int numPly, int
 }
 
 // get array index from zobrist key
-int TranspositionTable::getIndex()
+int TranspositionTable::getIndex(U64 key)
 {
-	return board.getZobristKey() % size;
+	return key % size;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <optional>
 #include "Board.h"
@@ -14,44 +15,49 @@ enum NodeType
 };
 
 // an entry into the transposition table, 1 entry = 16 bytes
+// the check word is the key xor'd with the data, so entries torn by concurrent writes of other search threads are rejected
 struct Entry
 {
-	// order of fields matters because of bit field functionality
-	U64 key : 64; // 64 bit key
-	int eval : 32; // normal integer
-	unsigned int depth : 8; // 255 - max depth
-	unsigned int from : 6; // 64 squares
-	unsigned int to : 6; // 64 squares
-	unsigned int promotion : 4; // 13 pieces, 1 gets added to piece so empty pieces are 0
-	unsigned int nodeType : 2; // 3 node types
-	unsigned int valid : 1; // boolean whether entry is valid or empty entry generated from the start (which would have valid set to zero because of zero-initialization)
+	std::atomic<U64> check;
+	std::atomic<U64> data; // bits 0-31: eval, 32-39: depth, 40-55: packed move, 56-57: node type, 58: valid
 };
 
-// class for the transposition table
+// unpacked data of an entry
+struct EntryData
+{
+	int eval;
+	int depth; // 255 - max depth
+	Move move; // null moves are 0
+	int nodeType;
+	bool valid; // entries generated from the start are zero-initialized and therefore invalid
+};
+
+// class for the transposition table, shared by all search threads and independent of any board
 class TranspositionTable
 {
 	// size of entry hash table, default - 64 MB
 	int size = 4000000;
 	std::vector<Entry> entries;
 
-	// board variable
-	Board& board;
+	// read and write entries of a position
+	EntryData load(U64 key);
+	void save(U64 key, EntryData data);
 
 public:
 	// constructor and clear table
-	TranspositionTable(Board& boardPar);
+	TranspositionTable();
 	void clear();
 
 	// set size in megabytes
 	void setSizeMB(int sizeMB);
 
-	// store an entry for current position
-	void storeEntry(int eval, int depth, Move move, int nodeType, int numPly);
+	// store an entry for a position
+	void storeEntry(U64 key, int eval, int depth, Move move, int nodeType, int numPly);
 
-	// get stored move and eval for current board position
-	std::optional<Move> getStoredMove(Board& board, bool exact);
-	std::optional<int> getStoredEval(int depth, int numPly, int alpha, int beta);
+	// get stored move and eval for a position
+	std::optional<Move> getStoredMove(U64 key, bool exact);
+	std::optional<int> getStoredEval(U64 key, int depth, int numPly, int alpha, int beta);
 
-	// get current index in table
-	int getIndex();
+	// get index of a position in table
+	int getIndex(U64 key);
 };
\ No newline at end of file
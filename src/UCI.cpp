@@ -20,15 +20,27 @@ int UCI::execute()
 		std::string input;
 		std::getline(std::cin, input);
 
+		// commands which change or read the engine state wait for a running search, all others are handled right away
+		bool changesState = input.rfind("position", 0) == 0 || input.rfind("go", 0) == 0 || input.rfind("setoption name", 0) == 0 || input.rfind("perftsuite", 0) == 0
+			|| input == "ucinewgame" || input == "eval" || input == "fen" || input == "speed test";
+		if (changesState)
+		{
+			engine.waitForSearch();
+		}
+
 		// if input is "uci", output all id and option information
 		if (input == "uci")
 		{
-			std::cout << "id name QuintBot\n";
+			std::cout << "id name QuintBot (" << Cpu::getName() << ")\n";
 			std::cout << "id author Quintium\n";
 
 			std::cout << "option name Hash type spin default 64 min 1 max 32000\n";
 			std::cout << "option name OwnBook type check default true\n";
 			std::cout << "option name Move Overhead type spin default 10 min 0 max 10000\n";
+			std::cout << "option name Threads type spin default 1 min 1 max 256\n";
+			std::cout << "option name Ponder type check default false\n";
+			std::cout << "option name LMR Base type spin default 75 min 0 max 500\n";
+			std::cout << "option name LMR Divisor type spin default 225 min 50 max 1000\n";
 
 			std::cout << "uciok\n";
 		}
@@ -36,7 +48,19 @@ int UCI::execute()
 		// ready information for syncing
 		if (input == "isready")
 		{
-			std::cout << "readyok\n";
+			std::cout << "readyok\n" << std::flush;
+		}
+
+		// stop the search, it prints its best move
+		if (input == "stop")
+		{
+			engine.stopSearch();
+		}
+
+		// the opponent played the expected move, the ponder search continues as a normal search
+		if (input == "ponderhit")
+		{
+			engine.ponderHit();
 		}
 
 		// set up new game
@@ -45,9 +69,11 @@ int UCI::execute()
 			engine.newGame();
 		}
 
-		// exit program on command
+		// exit program on command, after ending the search
 		if (input == "quit")
 		{
+			engine.stopSearch();
+			engine.waitForSearch();
 			return true;
 		}
 
@@ -69,12 +95,19 @@ int UCI::execute()
 			uciGo(input);
 		}
 
+		// run perft on every position of an EPD file and compare with the expected node counts
+		if (input.rfind("perftsuite", 0) == 0)
+		{
+			runPerftSuite(input);
+		}
+
 		// speed test on position with depth 8
 		if (input == "speed test")
 		{
 			engine.newGame();
 			engine.loadFromFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 15");
-			engine.getBestMove(-1, 0, 8, -1);
+			engine.startSearch(-1, 0, 8, -1);
+			engine.waitForSearch();
 		}
 
 		// evaluation for debugging reasons
@@ -119,6 +152,21 @@ void UCI::uciSetOption(std::string input)
 	{
 		engine.setMoveOverhead(std::stoi(optionValue));
 	}
+
+	if (optionName == "Threads")
+	{
+		engine.setThreads(std::stoi(optionValue));
+	}
+
+	if (optionName == "LMR Base")
+	{
+		engine.setReductionBase(std::stoi(optionValue));
+	}
+
+	if (optionName == "LMR Divisor")
+	{
+		engine.setReductionDivisor(std::stoi(optionValue));
+	}
 }
 
 // handle position uci command
@@ -164,7 +212,7 @@ void UCI::uciPosition(std::string input)
 
 			// get move until the next space and make that move
 			std::string moveStr = input.substr(movePos, nextSpace - movePos);
-			engine.makeMove(Move::loadFromNotation(moveStr, engine.getBoard().getPiecesMB()));
+			engine.makeMove(Move::loadFromNotation(moveStr, engine.getBoard()));
 			movePos = nextSpace + 1;
 		}
 	}
@@ -178,11 +226,12 @@ void UCI::uciGo(std::string input)
 	index = input.find("perft");
 	if (index != std::string::npos)
 	{
-		// execute perft
-		index += 6;
-		size_t spaceIndex = input.find(" ", index);
-		int perftDepth = std::stoi(input.substr(index, spaceIndex - index));
-		runPerft(perftDepth, true);
+		// execute perft, given as "perft <depth>" and optionally followed by "threads <n>" and "hash <MB>"
+		int perftDepth = 0, threads = 1, hashMB = 0;
+		if (getPerftOption(input, "perft", perftDepth) && getPerftOption(input, "threads", threads) && getPerftOption(input, "hash", hashMB))
+		{
+			runPerft(perftDepth, threads, hashMB);
+		}
 	}
 	else
 	{
@@ -230,60 +279,174 @@ void UCI::uciGo(std::string input)
 			depth = std::stoi(input.substr(index, spaceIndex - index));
 		}
 
-		// get the best move and print it out
-		Move move = engine.getBestMove(timeLeft, increment, depth, exactTime);
-		std::cout << "bestmove " << move.getNotation() << "\n";
+		// search until stop if "infinite" is given, and until stop or ponderhit if "ponder" is given
+		bool infinite = input.find("infinite") != std::string::npos;
+		bool ponder = input.find("ponder") != std::string::npos;
+
+		// search for the best move, it's printed out by the search thread
+		engine.startSearch(timeLeft, increment, depth, exactTime, infinite, ponder);
+	}
+}
+
+// get a numeric option of the perft commands, given as "<name> <value>", the value stays unchanged if the option is missing
+// returns false and reports the option if its value is malformed
+bool UCI::getPerftOption(std::string input, std::string name, int& value)
+{
+	size_t index = input.find(" " + name + " ");
+	if (index == std::string::npos)
+	{
+		return true;
+	}
+
+	index += name.size() + 2;
+	std::string valueString = input.substr(index, input.find(" ", index) - index);
+
+	std::istringstream stream(valueString);
+	int parsedValue;
+	std::string rest;
+	if (!(stream >> parsedValue) || stream >> rest)
+	{
+		std::cout << "Could not parse \"" << name << " " << valueString << "\"\n";
+		return false;
 	}
+
+	value = std::max(0, parsedValue);
+	return true;
 }
 
 // run performance test
-void UCI::runPerft(int depth, bool divide)
+void UCI::runPerft(int depth, int threads, int hashMB)
 {
+	Perft perft(hashMB, threads);
+
 	auto start = std::chrono::system_clock::now();
 
 	// calculate the nodes searched at given depth
-	long long nodes = tree(depth, divide);
+	U64 nodes = perft.run(engine.getBoard(), depth, true);
 
 	auto end = std::chrono::system_clock::now();
 	std::chrono::duration<double> diff = end - start;
 	double timePassed = diff.count();
 
-	// print out perft stats
+	// print out perft stats with the variant that was used
 	std::cout << "Depth " << depth << ": " << nodes << " nodes searched.\n";
+	std::cout << "Variant: bulk counting, " << (hashMB > 0 ? std::to_string(hashMB) + " MB hash" : "no hash") << ", " << perft.getThreads() << (perft.getThreads() == 1 ? " thread" : " threads") << "\n";
 	std::cout << "Time needed: " << timePassed << "s\n";
-	std::cout << "Nodes per second: " << nodes / timePassed << "\n";
+	std::cout << "Nodes per second: " << (U64)(nodes / timePassed) << "\n";
 }
 
-// calculate game tree for performance test
-long long UCI::tree(int depth, bool divide)
+// run perft suite, follows the format "perftsuite <file> [depth <max depth>] [threads <n>] [hash <MB>]"
+// every line of the file contains a FEN followed by the expected node counts, e.g. "<fen> ;D1 20 ;D2 400"
+void UCI::runPerftSuite(std::string input)
 {
-	long long nodes = 0;
+	// strip off the "perftsuite " and get the file name
+	input = input.substr(std::min(input.size(), (size_t)11));
+	std::string fileName = input.substr(0, input.find(" "));
 
-	engine.getBoard().generateMoves();
-	std::vector<Move> currentMoveList = engine.getBoard().getMoveList();
+	int maxDepth = 6, threads = 1, hashMB = 0;
+	if (!getPerftOption(input, "depth", maxDepth) || !getPerftOption(input, "threads", threads) || !getPerftOption(input, "hash", hashMB))
+	{
+		return;
+	}
+	Perft perft(hashMB, threads);
 
-	// return the number of moves if depth is 1
-	if (depth == 1)
+	std::ifstream file(fileName);
+	if (!file.is_open())
 	{
-		return (int)currentMoveList.size();
+		std::cout << "Could not open " << fileName << "\n";
+		return;
 	}
 
-	// loop through all legal moves
-	for (const Move& move : currentMoveList)
+	Board board;
+	std::vector<StateInfo> states;
+	board.setStateStack(states);
+	int positions = 0, passed = 0;
+	U64 totalNodes = 0;
+	double totalTime = 0;
+
+	std::string line;
+	while (std::getline(file, line))
 	{
-		// make the move and calculate the nodes in the game tree after this move
-		engine.makeMove(move);
-		long long change = tree(depth - 1, false);
+		// split the line at semicolons, the first part is the FEN
+		std::vector<std::string> parts;
+		size_t start = 0;
+		while (start <= line.size())
+		{
+			size_t end = std::min(line.find(";", start), line.size());
+			parts.push_back(line.substr(start, end - start));
+			start = end + 1;
+		}
+
+		// trim the FEN and add move counters if they are missing
+		std::string fen = parts[0];
+		fen.erase(0, fen.find_first_not_of(" \t\r"));
+		fen.erase(fen.find_last_not_of(" \t\r") + 1);
+		if (fen.empty())
+		{
+			continue;
+		}
+		if (std::count(fen.begin(), fen.end(), ' ') == 3)
+		{
+			fen += " 0 1";
+		}
 
-		// print out number of nodes after each move
-		if (divide)
+		board.loadFromFen(fen);
+		positions++;
+
+		bool positionPassed = true;
+		U64 positionNodes = 0;
+		auto positionStart = std::chrono::system_clock::now();
+
+		// run perft for every expected node count up to the maximum depth
+		for (size_t i = 1; i < parts.size(); i++)
 		{
-			std::cout << Square::toString(move.from) + Square::toString(move.to) << ": " << change << "\n";
+			size_t depthIndex = parts[i].find("D");
+			if (depthIndex == std::string::npos)
+			{
+				continue;
+			}
+
+			// fields have the format "D<depth> <node count>", malformed fields fail the position
+			std::istringstream field(parts[i].substr(depthIndex + 1));
+			int depth;
+			U64 expected;
+			std::string rest;
+			if (!(field >> depth >> expected) || depth < 1 || field >> rest)
+			{
+				positionPassed = false;
+				std::cout << "  Could not parse \"" << parts[i] << "\"\n";
+				continue;
+			}
+			if (depth > maxDepth)
+			{
+				continue;
+			}
+
+			U64 nodes = perft.run(board, depth);
+			positionNodes += nodes;
+
+			if (nodes != expected)
+			{
+				positionPassed = false;
+				std::cout << "  D" << depth << ": expected " << expected << ", got " << nodes << "\n";
+			}
 		}
 
-		nodes += change;
-		engine.unmakeMove(move);
+		std::chrono::duration<double> diff = std::chrono::system_clock::now() - positionStart;
+		double timePassed = diff.count();
+
+		passed += positionPassed;
+		totalNodes += positionNodes;
+		totalTime += timePassed;
+
+		// print out stats of the position
+		std::cout << "Position " << positions << ": " << (positionPassed ? "passed" : "FAILED") << ", " << positionNodes << " nodes, "
+			<< timePassed << "s, " << (U64)(positionNodes / std::max(timePassed, 1e-9)) << " nps (" << fen << ")\n";
 	}
 
-	return nodes;
+	// print out stats of the whole suite
+	std::cout << "Passed " << passed << "/" << positions << " positions\n";
+	std::cout << "Total nodes: " << totalNodes << "\n";
+	std::cout << "Time needed: " << totalTime << "s\n";
+	std::cout << "Nodes per second: " << (U64)(totalNodes / std::max(totalTime, 1e-9)) << "\n";
 }
\ No newline at end of file
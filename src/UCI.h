@@ -1,5 +1,8 @@
+#include <fstream>
+#include <sstream>
 #include "Engine.h"
 #include "Board.h"
+#include "Perft.h"
 
 // class for handling UCI protocol requests
 class UCI
@@ -13,8 +16,9 @@ private:
 	void uciGo(std::string input);
 
 	// performance test
-	void runPerft(int depth, bool divide);
-	long long tree(int depth, bool divide);
+	bool getPerftOption(std::string input, std::string name, int& value);
+	void runPerft(int depth, int threads, int hashMB);
+	void runPerftSuite(std::string input);
 
 public:
 	UCI();
@@ -1,35 +1,88 @@
 #include "Zobrist.h"
 
-Zobrist::Zobrist()
+// n-th number of a splitmix64 sequence, stateless so that it can be used at compile time
+static constexpr U64 randomNumber(int n)
 {
-	// create random number generator and int distribution
-	std::mt19937_64 generator(3838397628);
-	std::uniform_int_distribution<U64> distribution(U64(0), ~U64(0));
+	U64 z = U64(3838397628) + U64(n + 1) * U64(0x9E3779B97F4A7C15);
+	z = (z ^ (z >> 30)) * U64(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * U64(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
 
-	// create a random number for every piece and square
+// create a random number for every piece and square
+constexpr std::array<std::array<U64, 64>, 12> Zobrist::pieceRandoms = []()
+{
+	std::array<std::array<U64, 64>, 12> randoms = {};
 	for (int i = 0; i < 12; i++)
 	{
 		for (int j = 0; j < 64; j++)
 		{
-			pieceRandoms[i][j] = distribution(generator);
+			randoms[i][j] = randomNumber(i * 64 + j);
 		}
 	}
 
-	// create random number for turn
-	turnRandom = distribution(generator);
+	return randoms;
+}();
 
-	// create random numbers for castling rights
-	for (int i = 0; i < 4; i++)
-	{
-		castlingRandoms[i] = distribution(generator);
-	}
+// create random numbers for turn, castling rights and en passant files
+constexpr U64 Zobrist::turnRandom = randomNumber(768);
+constexpr std::array<U64, 4> Zobrist::castlingRandoms = { randomNumber(769), randomNumber(770), randomNumber(771), randomNumber(772) };
+constexpr std::array<U64, 8> Zobrist::enPassantRandoms = { randomNumber(773), randomNumber(774), randomNumber(775), randomNumber(776),
+														   randomNumber(777), randomNumber(778), randomNumber(779), randomNumber(780) };
+
+// cuckoo hash functions for the key change of a move
+static constexpr int cuckooHash1(U64 key)
+{
+	return (int)(key & 0x1FFF);
+}
 
-	// create random numbers for en passant files
-	for (int i = 0; i < 8; i++)
+static constexpr int cuckooHash2(U64 key)
+{
+	return (int)((key >> 16) & 0x1FFF);
+}
+
+// insert the key change of every reversible move (non-pawn piece moves on an empty board) into cuckoo tables
+constexpr CuckooTables Zobrist::cuckooTables = []()
+{
+	CuckooTables tables = {};
+	for (int piece = 0; piece < PAWN; piece++)
 	{
-		enPassantRandoms[i] = distribution(generator);
+		int pieceType = piece / 2 * 2;
+		for (int from = 0; from < 64; from++)
+		{
+			for (int to = from + 1; to < 64; to++)
+			{
+				int fileDistance = (from % 8 > to % 8) ? from % 8 - to % 8 : to % 8 - from % 8;
+				int rankDistance = (from / 8 > to / 8) ? from / 8 - to / 8 : to / 8 - from / 8;
+				bool orthogonal = fileDistance == 0 || rankDistance == 0;
+				bool diagonal = fileDistance == rankDistance;
+
+				bool reachable = (pieceType == KING && fileDistance <= 1 && rankDistance <= 1)
+					|| (pieceType == KNIGHT && fileDistance * rankDistance == 2)
+					|| (pieceType == ROOK && orthogonal)
+					|| (pieceType == BISHOP && diagonal)
+					|| (pieceType == QUEEN && (orthogonal || diagonal));
+				if (!reachable)
+				{
+					continue;
+				}
+
+				// insert the move, displacing entries to their other slot until a free slot is found
+				U64 key = pieceRandoms[piece][from] ^ pieceRandoms[piece][to] ^ turnRandom;
+				int move = from | (to << 6);
+				int index = cuckooHash1(key);
+				while (move != 0)
+				{
+					std::swap(tables.keys[index], key);
+					std::swap(tables.moves[index], move);
+					index = (index == cuckooHash1(key)) ? cuckooHash2(key) : cuckooHash1(key);
+				}
+			}
+		}
 	}
-}
+
+	return tables;
+}();
 
 void Zobrist::reset()
 {
@@ -75,4 +128,22 @@ void Zobrist::changeEnPassant(int file)
 U64 Zobrist::getHashKey()
 {
 	return hashKey;
+}
+
+// look up the key difference in both cuckoo slots
+bool Zobrist::findReversibleMove(U64 keyDiff, int& from, int& to)
+{
+	int index = cuckooHash1(keyDiff);
+	if (cuckooTables.keys[index] != keyDiff)
+	{
+		index = cuckooHash2(keyDiff);
+		if (cuckooTables.keys[index] != keyDiff)
+		{
+			return false;
+		}
+	}
+
+	from = cuckooTables.moves[index] & 0x3F;
+	to = cuckooTables.moves[index] >> 6;
+	return true;
 }
\ No newline at end of file
@@ -1,21 +1,28 @@
 #pragma once
-#include <random>
 #include "Bitboard.h"
 
+// cuckoo hash tables with the key changes of all reversible piece moves, used to detect upcoming repetitions
+struct CuckooTables
+{
+	std::array<U64, 8192> keys;
+	std::array<int, 8192> moves; // from square | to square << 6
+};
+
 // class for zobrist hashing
 class Zobrist
 {
-	// random numbers for all board information
-	std::array<std::array<U64, 64>, 12> pieceRandoms;
-	U64 turnRandom;
-	std::array<U64, 4> castlingRandoms;
-	std::array<U64, 8> enPassantRandoms;
+	// random numbers for all board information, generated at compile time
+	static const std::array<std::array<U64, 64>, 12> pieceRandoms;
+	static const U64 turnRandom;
+	static const std::array<U64, 4> castlingRandoms;
+	static const std::array<U64, 8> enPassantRandoms;
+
+	// key changes of reversible moves
+	static const CuckooTables cuckooTables;
 
 	U64 hashKey = U64(0);
 
 public:
-	Zobrist();
-
 	void reset();
 	void set(U64 key);
 
@@ -27,4 +34,7 @@ public:
 	void changeEnPassant(int file);
 
 	U64 getHashKey();
+
+	// find the reversible piece move which changes the key by the given difference
+	static bool findReversibleMove(U64 keyDiff, int& from, int& to);
 };
\ No newline at end of file